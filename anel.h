@@ -0,0 +1,66 @@
+#ifndef ANEL_H
+#define ANEL_H
+
+#include "pico/stdlib.h"
+
+// Anel de um produtor e um consumidor (ex.: um em cada núcleo), sem travas:
+// só o produtor escreve 'escrita' e só o consumidor escreve 'leitura'. Os
+// itens são preenchidos e lidos no lugar, sem cópia extra:
+//   produtor:   item = anel_reservar(a); ...preenche...; anel_publicar(a);
+//   consumidor: item = anel_frente(a);   ...usa...;      anel_liberar(a);
+// Nenhuma das funções espera: anel cheio ou vazio devolve NULL.
+typedef struct
+{
+    uint32_t escrita;
+    uint32_t leitura;
+    uint32_t mascara; // Capacidade - 1 (potência de 2)
+    uint16_t tam_item;
+    uint8_t *itens;
+} Anel;
+
+static inline void anel_init(Anel *a, void *itens, uint16_t tam_item, uint32_t capacidade)
+{
+    a->escrita = 0;
+    a->leitura = 0;
+    a->mascara = capacidade - 1;
+    a->tam_item = tam_item;
+    a->itens = itens;
+}
+
+static inline uint32_t anel_ocupacao(const Anel *a)
+{
+    return __atomic_load_n(&a->escrita, __ATOMIC_ACQUIRE) - __atomic_load_n(&a->leitura, __ATOMIC_ACQUIRE);
+}
+
+static inline void *anel_reservar(Anel *a)
+{
+    uint32_t escrita = a->escrita;
+    if (escrita - __atomic_load_n(&a->leitura, __ATOMIC_ACQUIRE) > a->mascara)
+    {
+        return NULL;
+    }
+    return a->itens + (escrita & a->mascara) * a->tam_item;
+}
+
+// O item reservado fica visível ao consumidor só depois da barreira
+static inline void anel_publicar(Anel *a)
+{
+    __atomic_store_n(&a->escrita, a->escrita + 1, __ATOMIC_RELEASE);
+}
+
+static inline void *anel_frente(Anel *a)
+{
+    uint32_t leitura = a->leitura;
+    if (__atomic_load_n(&a->escrita, __ATOMIC_ACQUIRE) == leitura)
+    {
+        return NULL;
+    }
+    return a->itens + (leitura & a->mascara) * a->tam_item;
+}
+
+static inline void anel_liberar(Anel *a)
+{
+    __atomic_store_n(&a->leitura, a->leitura + 1, __ATOMIC_RELEASE);
+}
+
+#endif
@@ -0,0 +1,728 @@
+#include "aplicacao.h"
+#include "hal.h"
+#include "rotas.h"
+#include "calibracao.h"
+#include "publicacao.h"
+#include "estado_bin.h"
+#include "formato.h"
+#include "ciclos.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// Estado do cômodo em binário (estado_bin.h) em /casa/<comodo>/estado/bin:
+// 0 = só os tópicos de texto, 1 = texto + binário, 2 = só binário (os tópicos
+// de texto são recriados no PC por tools/estado_bin_bridge.py)
+#ifndef MQTT_ESTADO_BINARIO
+#define MQTT_ESTADO_BINARIO 0
+#endif
+
+#define MQTT_PUBLISH_RETAIN 0
+
+#ifndef DEBUG_printf
+#ifndef NDEBUG
+#define DEBUG_printf printf
+#else
+#define DEBUG_printf(...)
+#endif
+#endif
+
+#ifndef INFO_printf
+#define INFO_printf printf
+#endif
+
+// Variável para alternar o cômodo atual
+Comodo *comodo_atual = &comodos_estado[COMODO_sala]; // Inicialmente aponta para "sala"
+
+// Tópicos de cada cômodo acompanhados pela camada de publicação (publicacao.h)
+enum
+{
+    PUB_ESTADO,
+    PUB_JANELA_ESTADO,
+    PUB_JANELA_POS,
+    PUB_LUZ_ESTADO,
+    PUB_LUZ,
+    PUB_ESTADO_BIN,
+    PUB_NUM_CAMPOS
+};
+#define PUB_ESTADOS ((1u << PUB_ESTADO) | (1u << PUB_JANELA_ESTADO) | (1u << PUB_JANELA_POS) | (1u << PUB_LUZ_ESTADO))
+#define PUB_SLOT(comodo, campo) ((comodo) * PUB_NUM_CAMPOS + (campo))
+#define PUB_SLOT_TEMPERATURA (NUM_COMODOS * PUB_NUM_CAMPOS)
+#define PUB_SLOT_HORARIO (PUB_SLOT_TEMPERATURA + 1)
+_Static_assert(PUB_SLOT_HORARIO < PUBLICACAO_MAX_SLOTS, "aumente PUBLICACAO_MAX_SLOTS");
+
+static inline uint indice_comodo(const Comodo *comodo)
+{
+    return comodo - comodos_estado;
+}
+
+static inline uint32_t agora_ms(void)
+{
+    return hal_agora_ms();
+}
+
+static CiclosMedida ciclos_automacao; // Custo do controle por ciclo do worker
+
+// Luz publicada de cada cômodo, com zona morta de 0,5%: o estado só muda, e só
+// é publicado de novo, quando a leitura sai da zona
+static int32_t luz_publicada[NUM_COMODOS];
+static uint32_t ultimo_heartbeat_ms = 0;
+
+// EVENTO_* acumulados durante um comando ou ciclo; saem juntos no fim, com o
+// estado já consistente, para quem o mostra (hal_notificar)
+static uint32_t mudancas = 0;
+
+static void control_led(bool on);
+static void publish_temperature(void);
+static void publish_light(void);
+static void publish_controle(Comodo *comodo);
+static void set_janela(Comodo *comodo, uint16_t pos);
+static void set_luz(Comodo *comodo, bool on);
+static void automacao_iluminacao(void);
+static void publish_all_states(void);
+static void marcar_heartbeat(void);
+static void enviar_publicacoes(void);
+static void publish_estado(Comodo *comodo);
+static void publish_horario(void);
+static void publish_janela_estado(Comodo *comodo);
+static void publish_janela_pos(Comodo *comodo);
+static void publish_luz_estado(Comodo *comodo);
+#if MQTT_ESTADO_BINARIO
+static void publish_estado_bin(Comodo *comodo);
+#endif
+static void calibrar_comodo(Comodo *comodo, const char *comando);
+static void registrar_rotas(void);
+static void notificar_mudancas(void);
+static bool transporte_mqtt(void *ctx, uint slot, const char *topico, const void *payload, uint16_t len, bool retain);
+static bool slot_telemetria(uint slot);
+static void remarcar_slot(uint slot);
+
+void init_aplicacao(void)
+{
+    for (uint i = 0; i < NUM_COMODOS; i++)
+    {
+        luz_publicada[i] = -1000; // Primeira leitura sempre sai
+    }
+    init_publicacao(transporte_mqtt, NULL, PUBLICACAO_HEARTBEAT_MS);
+    registrar_rotas(); // Tabelas de tópicos montadas uma vez, antes de chegar qualquer mensagem
+}
+
+void aplicacao_mensagem(const char *topico, const char *payload)
+{
+    if (!rotas_despachar(NULL, topico, payload))
+    {
+        DEBUG_printf("No route for %s\n", topico);
+    }
+    enviar_publicacoes(); // Mudanças feitas pelo comando saem juntas
+    notificar_mudancas();
+}
+
+void aplicacao_conectado(void)
+{
+    publicacao_esquecer(); // Sessão nova: todo estado retido é reenviado
+
+    // Garantir os estados iniciais e publicar explicitamente
+    controle_reiniciar(&comodo_atual->controle, agora_ms());
+    comodo_atual->modo_auto = true; // Confirmar modo automático no início
+    hal_mqtt_publicar(hal_mqtt_topico(comodo_atual->topicos->modo), "auto", strlen("auto"), MQTT_PUBLISH_RETAIN, SAIDA_ESTADO);
+    comodo_atual->modo_dormir = false; // Confirmar modo dormir desativado no início
+    hal_mqtt_publicar(hal_mqtt_topico(comodo_atual->topicos->modo_dormir), "off", strlen("off"), MQTT_PUBLISH_RETAIN, SAIDA_ESTADO);
+    publish_all_states(); // Publicar todos os estados iniciais, incluindo modo e modo_dormir
+    enviar_publicacoes();
+    mudancas |= EVENTO_MODO;
+    notificar_mudancas();
+
+    // Publicar o valor padrão de iluminacao_alvo no tópico /casa/<comodo>/luz/set
+    char alvo_str[16];
+    formato_centesimos(alvo_str, sizeof(alvo_str), COMODO_ILUMINACAO_ALVO);
+    hal_mqtt_publicar(hal_mqtt_topico(comodo_atual->topicos->luz_set), alvo_str, strlen(alvo_str), MQTT_PUBLISH_RETAIN, SAIDA_ESTADO);
+}
+
+void aplicacao_ciclo(void)
+{
+#ifndef NDEBUG
+    uint64_t inicio_tick = ciclos_agora();
+#endif
+    publish_temperature();
+    publish_light();
+    publish_horario();
+    ciclos_iniciar(&ciclos_automacao);
+    if (comodo_atual->modo_auto && !comodo_atual->modo_dormir)
+    {
+        automacao_iluminacao();
+    }
+    ciclos_terminar(&ciclos_automacao);
+    // Marcar os estados a cada ciclo; só saem os que mudaram ou venceram o heartbeat
+    publish_all_states();
+    marcar_heartbeat();
+    enviar_publicacoes();
+    notificar_mudancas();
+
+#ifndef NDEBUG
+    DEBUG_printf("ciclos: automacao %u, tick %u\n", (unsigned)ciclos_automacao.total, (unsigned)(ciclos_agora() - inicio_tick));
+    SensoresContadores contadores;
+    sensores_contadores(&contadores);
+    DEBUG_printf("sensores: %u leituras do cache, %u leituras do ADC\n", contadores.acertos, contadores.falhas);
+    PublicacaoContadores publicacoes;
+    publicacao_contadores(&publicacoes);
+    DEBUG_printf("publicacao: %u enviadas, %u suprimidas, %u falhas\n", publicacoes.enviadas, publicacoes.suprimidas, publicacoes.falhas);
+#endif
+}
+
+static void control_led(bool on)
+{
+    const char *message = on ? "On" : "Off";
+    hal_set_led(on);
+
+    hal_mqtt_publicar(hal_mqtt_topico("/led/state"), message, strlen(message), MQTT_PUBLISH_RETAIN, SAIDA_RESPOSTA);
+}
+
+static void publish_temperature(void)
+{
+    const char *temperature_key = hal_mqtt_topico("/temperature");
+    float temperature = sensores_temperatura();
+    char temp_str[16];
+    formato_decimal2(temp_str, sizeof(temp_str), temperature);
+    if (publicacao_publicar(PUB_SLOT_TEMPERATURA, temperature_key, temp_str, MQTT_PUBLISH_RETAIN))
+    {
+        INFO_printf("Published %s to %s\n", temp_str, temperature_key);
+    }
+}
+
+static void rota_led(void *ctx, Comodo *comodo, const char *topico, const char *payload)
+{
+    if (strcasecmp(payload, "on") == 0 || strcmp(payload, "1") == 0)
+    {
+        INFO_printf("Received /led: %s\n", payload);
+        control_led(true);
+    }
+    else if (strcasecmp(payload, "off") == 0 || strcmp(payload, "0") == 0)
+    {
+        INFO_printf("Received /led: %s\n", payload);
+        control_led(false);
+    }
+}
+
+static void rota_print(void *ctx, Comodo *comodo, const char *topico, const char *payload)
+{
+    INFO_printf("Received /print: %s\n", payload);
+    INFO_printf("%s\n", payload);
+}
+
+static void rota_ping(void *ctx, Comodo *comodo, const char *topico, const char *payload)
+{
+    INFO_printf("Received /ping\n");
+    char buffer[32];
+    formato_inteiro(buffer, sizeof(buffer), hal_agora_ms() / 1000, 0);
+    hal_mqtt_publicar(hal_mqtt_topico("/uptime"), buffer, strlen(buffer), MQTT_PUBLISH_RETAIN, SAIDA_RESPOSTA);
+}
+
+static void rota_exit(void *ctx, Comodo *comodo, const char *topico, const char *payload)
+{
+    INFO_printf("Received /exit\n");
+    hal_mqtt_encerrar();
+}
+
+static void rota_select(void *ctx, Comodo *comodo, const char *topico, const char *payload)
+{
+    INFO_printf("Received /casa/select with payload: '%s'\n", payload);
+
+    // Remover a barra inicial, se presente
+    if (payload[0] == '/')
+    {
+        payload++; // Avança o ponteiro para ignorar o '/'
+    }
+
+    for (uint i = 0; i < count_of(comodos); i++)
+    {
+        if (strcmp(payload, comodos[i]->nome) == 0)
+        {
+            INFO_printf("Switching to comodo: %s\n", comodos[i]->nome);
+            comodo_atual = comodos[i];
+            mudancas |= EVENTO_COMODO;
+            set_janela(comodo_atual, comodo_atual->janela_pos); // O servo e a luz passam a mostrar este cômodo
+            set_luz(comodo_atual, comodo_atual->luz_ligada);
+            controle_reiniciar(&comodo_atual->controle, agora_ms());
+            publish_all_states();
+            return;
+        }
+    }
+    INFO_printf("Selection ignored: unknown payload='%s'\n", payload);
+}
+
+static void rota_luz_set(void *ctx, Comodo *target_comodo, const char *topico, const char *payload)
+{
+    int32_t nova_alvo;
+    if (formato_ler_centesimos(payload, &nova_alvo) && nova_alvo >= 0 && nova_alvo <= COMODO_100_PORCENTO)
+    {
+        INFO_printf("Received %s: %s\n", topico, payload);
+        target_comodo->iluminacao_alvo = nova_alvo;
+        mudancas |= EVENTO_MODO;
+        publicacao_marcar(indice_comodo(target_comodo), 1u << PUB_ESTADO); // Publicar o novo valor no estado do cômodo alvo
+    }
+}
+
+static void rota_janela_set(void *ctx, Comodo *target_comodo, const char *topico, const char *payload)
+{
+    if (!target_comodo->modo_dormir && !target_comodo->modo_auto)
+    {
+        int32_t nova_pos;
+        if (formato_ler_centesimos(payload, &nova_pos) && nova_pos >= 0 && nova_pos <= COMODO_100_PORCENTO)
+        {
+            INFO_printf("Received %s: %s\n", topico, payload);
+            set_janela(target_comodo, nova_pos);
+            publish_all_states();
+        }
+    }
+    else
+    {
+        INFO_printf("Command ignored: modo_dormir=%d or modo_auto=%d for %s\n", target_comodo->modo_dormir, target_comodo->modo_auto, target_comodo->nome);
+    }
+}
+
+static void rota_janela_abrir(void *ctx, Comodo *target_comodo, const char *topico, const char *payload)
+{
+    if (!target_comodo->modo_dormir && !target_comodo->modo_auto)
+    {
+        if (strcasecmp(payload, "on") == 0)
+        {
+            INFO_printf("Received %s: on\n", topico);
+            set_janela(target_comodo, COMODO_100_PORCENTO);
+        }
+        else if (strcasecmp(payload, "off") == 0)
+        {
+            INFO_printf("Received %s: off\n", topico);
+            set_janela(target_comodo, 0);
+        }
+        publish_all_states();
+    }
+    else
+    {
+        INFO_printf("Command ignored: modo_dormir=%d or modo_auto=%d for %s\n", target_comodo->modo_dormir, target_comodo->modo_auto, target_comodo->nome);
+    }
+}
+
+static void rota_luz_ligar(void *ctx, Comodo *target_comodo, const char *topico, const char *payload)
+{
+    if (!target_comodo->modo_dormir && !target_comodo->modo_auto)
+    {
+        if (strcasecmp(payload, "on") == 0)
+        {
+            INFO_printf("Received %s: on\n", topico);
+            set_luz(target_comodo, true);
+        }
+        else if (strcasecmp(payload, "off") == 0)
+        {
+            INFO_printf("Received %s: off\n", topico);
+            set_luz(target_comodo, false);
+        }
+        publish_all_states();
+    }
+    else
+    {
+        INFO_printf("Command ignored: modo_dormir=%d or modo_auto=%d for %s\n", target_comodo->modo_dormir, target_comodo->modo_auto, target_comodo->nome);
+    }
+}
+
+static void rota_modo(void *ctx, Comodo *target_comodo, const char *topico, const char *payload)
+{
+    if (!target_comodo->modo_dormir)
+    {
+        if (strcasecmp(payload, "auto") == 0)
+        {
+            INFO_printf("Received %s: auto\n", topico);
+            controle_reiniciar(&target_comodo->controle, agora_ms());
+            target_comodo->modo_auto = true;
+        }
+        else if (strcasecmp(payload, "manual") == 0)
+        {
+            INFO_printf("Received %s: manual\n", topico);
+            target_comodo->modo_auto = false;
+        }
+        mudancas |= EVENTO_MODO;
+        publish_all_states();
+    }
+    else
+    {
+        INFO_printf("Command ignored: modo_dormir=%d for %s\n", target_comodo->modo_dormir, target_comodo->nome);
+    }
+}
+
+static void rota_modo_dormir(void *ctx, Comodo *target_comodo, const char *topico, const char *payload)
+{
+    if (strcmp(payload, "on") == 0)
+    {
+        INFO_printf("Received %s: on\n", topico);
+        target_comodo->modo_dormir = true;
+        mudancas |= EVENTO_MODO;
+        set_luz(target_comodo, false);
+        set_janela(target_comodo, 0);
+        target_comodo->modo_auto = false;
+        hal_mqtt_publicar(hal_mqtt_topico(topico), "manual", strlen("manual"), MQTT_PUBLISH_RETAIN, SAIDA_ESTADO);
+        publish_all_states();
+    }
+    else if (strcmp(payload, "off") == 0)
+    {
+        INFO_printf("Received %s: off\n", topico);
+        target_comodo->modo_dormir = false;
+        mudancas |= EVENTO_MODO;
+        controle_reiniciar(&target_comodo->controle, agora_ms());
+        target_comodo->modo_auto = true;
+        hal_mqtt_publicar(hal_mqtt_topico(topico), "auto", strlen("auto"), MQTT_PUBLISH_RETAIN, SAIDA_ESTADO);
+        publish_all_states();
+    }
+}
+
+static void rota_calibrar(void *ctx, Comodo *target_comodo, const char *topico, const char *payload)
+{
+    calibrar_comodo(target_comodo, payload);
+}
+
+// Ganhos do controlador do cômodo: "kp=0.1 ki=0.1 kd=0 ff=1" (só os presentes mudam)
+static void rota_controle(void *ctx, Comodo *target_comodo, const char *topico, const char *payload)
+{
+    if (controle_ler_ganhos(&target_comodo->controle, payload))
+    {
+        INFO_printf("Received %s: %s\n", topico, payload);
+    }
+    publish_controle(target_comodo);
+}
+
+// Rotas "/casa/<comodo>/<caminho>", geradas de COMODO_COMANDOS; o cômodo chega já resolvido ao handler
+#define ROTA_COMODO(nome, handler, caminho) {caminho, handler},
+static const Rota rotas_comodo[] = {COMODO_COMANDOS(ROTA_COMODO, "")};
+#undef ROTA_COMODO
+
+static const Rota rotas_globais[] = {
+    {"/led", rota_led},
+    {"/print", rota_print},
+    {"/ping", rota_ping},
+    {"/exit", rota_exit},
+    {"/casa/select", rota_select},
+};
+
+_Static_assert(NUM_COMODOS <= ROTAS_MAX_CHAVES, "aumente ROTAS_TAM_TABELA para tantos comodos");
+
+static void registrar_rotas(void)
+{
+    if (!init_rotas(comodos, count_of(comodos), rotas_comodo, count_of(rotas_comodo), rotas_globais, count_of(rotas_globais)))
+    {
+        panic("Tabela de rotas MQTT invalida");
+    }
+}
+
+static void notificar_mudancas(void)
+{
+    if (mudancas)
+    {
+        hal_notificar(mudancas);
+        mudancas = 0;
+    }
+}
+
+// Variações de até 0,5% repetem o último valor, que a camada de publicação suprime
+static int32_t luz_com_zona_morta(Comodo *comodo)
+{
+    int32_t luz = sensores_luz(comodo->ldr_entradas);
+    int32_t *publicada = &luz_publicada[indice_comodo(comodo)];
+    if (abs(luz - *publicada) > 50)
+    {
+        *publicada = luz;
+    }
+    return *publicada;
+}
+
+static void publish_light(void)
+{
+    const char *light_key = comodo_atual->topicos->luz;
+    comodo_atual->luz = sensores_luz(comodo_atual->ldr_entradas);
+    mudancas |= EVENTO_MEDIDA;
+    char light_str[16];
+    formato_centesimos(light_str, sizeof(light_str), luz_com_zona_morta(comodo_atual));
+    if (publicacao_publicar(PUB_SLOT(indice_comodo(comodo_atual), PUB_LUZ), light_key, light_str, MQTT_PUBLISH_RETAIN))
+    {
+        INFO_printf("Published %s to %s\n", light_str, light_key);
+    }
+}
+
+// Há um só servo e uma só luz: eles mostram o cômodo atual. Os outros cômodos
+// só guardam o estado, que vai para o hardware quando forem selecionados.
+static void set_janela(Comodo *comodo, uint16_t pos)
+{
+    pos = pos > COMODO_100_PORCENTO ? COMODO_100_PORCENTO : pos;
+    comodo->janela_pos = pos;
+    if (comodo == comodo_atual)
+    {
+        hal_set_janela(pos);
+    }
+    mudancas |= EVENTO_JANELA; // O painel mostra todos os cômodos
+}
+
+static void set_luz(Comodo *comodo, bool on)
+{
+    comodo->luz_ligada = on;
+    if (comodo == comodo_atual)
+    {
+        hal_set_luz(on);
+    }
+    mudancas |= EVENTO_LUZ;
+}
+
+// Um passo do controlador do cômodo (controle.c); a resposta é medida no próximo ciclo
+static void automacao_iluminacao(void)
+{
+    uint16_t luz_atual = sensores_luz(comodo_atual->ldr_entradas);
+    comodo_atual->luz = luz_atual;
+    Controle *controle = &comodo_atual->controle;
+    ControleAcao acao = controle_passo(controle, luz_atual, comodo_atual->iluminacao_alvo,
+                                       comodo_atual->janela_pos, comodo_atual->luz_ligada, agora_ms());
+
+    if (acao.janela_pos != comodo_atual->janela_pos)
+    {
+        set_janela(comodo_atual, acao.janela_pos);
+    }
+    if (acao.luz_ligada != comodo_atual->luz_ligada)
+    {
+        INFO_printf("%s: luz %s (luz %u, alvo %u)\n", comodo_atual->nome, acao.luz_ligada ? "ligada" : "desligada",
+                    luz_atual, comodo_atual->iluminacao_alvo);
+        set_luz(comodo_atual, acao.luz_ligada);
+    }
+    if (controle->medida_nova)
+    {
+        INFO_printf("%s: acomodou em %u ms, sobressinal %d\n", comodo_atual->nome, (unsigned)controle->acomodacao_ms,
+                    (int)controle->sobressinal_medido);
+        publish_controle(comodo_atual);
+    }
+}
+
+static void publish_estado(Comodo *comodo)
+{
+    const char *estado_key = comodo->topicos->estado;
+    char estado_str[128];
+    Json json;
+    json_abrir(&json, estado_str, sizeof(estado_str));
+    json_centesimos(&json, "luz", luz_com_zona_morta(comodo));
+    json_centesimos(&json, "janela", comodo->janela_pos);
+    json_inteiro(&json, "luz_ligada", comodo->luz_ligada);
+    json_texto(&json, "modo", comodo->modo_auto ? "auto" : "manual");
+    json_inteiro(&json, "modo_dormir", comodo->modo_dormir);
+    json_centesimos(&json, "iluminacao_alvo", comodo->iluminacao_alvo);
+    json_fechar(&json);
+    publicacao_publicar(PUB_SLOT(indice_comodo(comodo), PUB_ESTADO), estado_key, estado_str, MQTT_PUBLISH_RETAIN);
+}
+
+#if MQTT_ESTADO_BINARIO
+static void publish_estado_bin(Comodo *comodo)
+{
+    EstadoBin bin;
+    estado_bin_codificar(&bin, comodo, luz_com_zona_morta(comodo), sensores_temperatura());
+    publicacao_publicar_bytes(PUB_SLOT(indice_comodo(comodo), PUB_ESTADO_BIN), comodo->topicos->estado_bin, &bin, sizeof(bin), MQTT_PUBLISH_RETAIN);
+}
+#endif
+
+// Só marca os estados do cômodo atual; eles saem em enviar_publicacoes(),
+// uma vez por tópico, mesmo que sejam marcados várias vezes no mesmo ciclo
+static void publish_all_states(void)
+{
+    publicacao_marcar(indice_comodo(comodo_atual), PUB_ESTADOS);
+}
+
+// Os outros cômodos só são marcados por comandos: a cada heartbeat todos são
+// marcados, para que o estado retido que não mudou também seja reenviado
+static void marcar_heartbeat(void)
+{
+    uint32_t agora = agora_ms();
+    if (agora - ultimo_heartbeat_ms < PUBLICACAO_HEARTBEAT_MS)
+    {
+        return;
+    }
+    ultimo_heartbeat_ms = agora;
+    for (uint i = 0; i < NUM_COMODOS; i++)
+    {
+        publicacao_marcar(i, PUB_ESTADOS);
+    }
+}
+
+static void enviar_publicacoes(void)
+{
+    for (uint i = 0; i < NUM_COMODOS; i++)
+    {
+        uint32_t campos = publicacao_pendentes(i);
+#if MQTT_ESTADO_BINARIO
+        if (campos & PUB_ESTADOS)
+        {
+            publish_estado_bin(comodos[i]); // Uma mensagem com o estado inteiro
+        }
+#endif
+#if MQTT_ESTADO_BINARIO == 2
+        campos &= ~PUB_ESTADOS;
+#endif
+        if (campos & (1u << PUB_ESTADO))
+        {
+            publish_estado(comodos[i]); // Publica o estado geral, incluindo o modo
+        }
+        if (campos & (1u << PUB_JANELA_ESTADO))
+        {
+            publish_janela_estado(comodos[i]);
+        }
+        if (campos & (1u << PUB_JANELA_POS))
+        {
+            publish_janela_pos(comodos[i]);
+        }
+        if (campos & (1u << PUB_LUZ_ESTADO))
+        {
+            publish_luz_estado(comodos[i]);
+        }
+    }
+}
+
+static void publish_janela_estado(Comodo *comodo)
+{
+    const char *janela_estado_key = comodo->topicos->janela_estado;
+    const char *estado = (comodo->janela_pos > 0) ? "on" : "off";
+    if (publicacao_publicar(PUB_SLOT(indice_comodo(comodo), PUB_JANELA_ESTADO), janela_estado_key, estado, 1))
+    {
+        INFO_printf("Published to %s: %s\n", janela_estado_key, estado);
+    }
+}
+
+static void publish_janela_pos(Comodo *comodo)
+{
+    const char *janela_pos_key = comodo->topicos->janela_pos;
+    char pos_str[16];
+    formato_centesimos(pos_str, sizeof(pos_str), comodo->janela_pos);
+    if (publicacao_publicar(PUB_SLOT(indice_comodo(comodo), PUB_JANELA_POS), janela_pos_key, pos_str, 1))
+    {
+        INFO_printf("Published to %s: %s\n", janela_pos_key, pos_str);
+    }
+}
+
+static void publish_luz_estado(Comodo *comodo)
+{
+    const char *luz_estado_key = comodo->topicos->luz_estado;
+    const char *estado = comodo->luz_ligada ? "on" : "off";
+    if (publicacao_publicar(PUB_SLOT(indice_comodo(comodo), PUB_LUZ_ESTADO), luz_estado_key, estado, 1))
+    {
+        INFO_printf("Published to %s: %s\n", luz_estado_key, estado);
+    }
+}
+
+static void publish_horario(void)
+{
+    uint32_t seconds = hal_agora_ms() / 1000;
+    uint32_t hours = (seconds / 3600) % 24;
+    uint32_t minutes = (seconds / 60) % 60;
+    char horario_str[16];
+    size_t n = formato_inteiro(horario_str, sizeof(horario_str), hours, 2);
+    horario_str[n++] = ':';
+    formato_inteiro(horario_str + n, sizeof(horario_str) - n, minutes, 2);
+    publicacao_publicar(PUB_SLOT_HORARIO, hal_mqtt_topico("/casa/horario"), horario_str, MQTT_PUBLISH_RETAIN);
+}
+
+// Calibração do LDR pelo MQTT (/casa/<comodo>/calibrar):
+//   "<luz>"  registra a leitura atual dos LDRs do cômodo como <luz>% (medida com um luxímetro ou referência)
+//   "salvar" aplica os pontos registrados e grava as tabelas na flash
+//   "padrao" volta à conversão linear original
+static void calibrar_comodo(Comodo *comodo, const char *comando)
+{
+    char resposta[32];
+    if (strcasecmp(comando, "salvar") == 0)
+    {
+        bool ok = true;
+        for (uint i = 0; i < SENSORES_NUM_LDR; i++)
+        {
+            if ((comodo->ldr_entradas & (1u << i)) && calibracao_pontos(i) > 0)
+            {
+                ok &= calibracao_aplicar(i);
+            }
+        }
+        ok &= calibracao_salvar();
+        strcpy(resposta, ok ? "salvo" : "erro");
+    }
+    else if (strcasecmp(comando, "padrao") == 0)
+    {
+        for (uint i = 0; i < SENSORES_NUM_LDR; i++)
+        {
+            if (comodo->ldr_entradas & (1u << i))
+            {
+                calibracao_padrao(i);
+            }
+        }
+        strcpy(resposta, "padrao");
+    }
+    else
+    {
+        int32_t luz;
+        if (!formato_ler_centesimos(comando, &luz) || luz < 0 || luz > COMODO_100_PORCENTO)
+        {
+            return;
+        }
+        uint pontos = 0;
+        for (uint i = 0; i < SENSORES_NUM_LDR; i++)
+        {
+            if (comodo->ldr_entradas & (1u << i))
+            {
+                calibracao_adicionar_ponto(i, sensores_ldr_bruto(i), (uint16_t)luz);
+                pontos = calibracao_pontos(i);
+            }
+        }
+        size_t n = formato_inteiro(resposta, sizeof(resposta), pontos, 0);
+        strcpy(resposta + n, " pontos");
+    }
+
+    const char *topico = comodo->topicos->calibrar_estado;
+    INFO_printf("Publishing to %s: %s\n", topico, resposta);
+    hal_mqtt_publicar(topico, resposta, strlen(resposta), 0, SAIDA_RESPOSTA);
+    sensores_luz_atualizada(comodo->ldr_entradas);
+}
+
+// Ganhos, modelo medido e a última acomodação do controlador (retido)
+static void publish_controle(Comodo *comodo)
+{
+    char controle_str[160];
+    if (controle_descrever(&comodo->controle, controle_str, sizeof(controle_str)) == 0)
+    {
+        return;
+    }
+    const char *topico = comodo->topicos->controle_estado;
+    INFO_printf("Publishing to %s: %s\n", topico, controle_str);
+    hal_mqtt_publicar(topico, controle_str, strlen(controle_str), MQTT_PUBLISH_RETAIN, SAIDA_RESPOSTA);
+}
+
+void aplicacao_descartada(const char *topico)
+{
+    uint slot;
+    if (publicacao_invalidar(topico, &slot) && !slot_telemetria(slot))
+    {
+        remarcar_slot(slot); // A telemetria sai de novo no próximo ciclo de qualquer forma
+    }
+}
+
+// Luz medida, temperatura e horário são telemetria; o resto é estado dos cômodos
+static bool slot_telemetria(uint slot)
+{
+    return slot >= PUB_SLOT_TEMPERATURA || slot % PUB_NUM_CAMPOS == PUB_LUZ;
+}
+
+// Estado que não saiu continua sujo, inclusive dos cômodos que não são o atual
+// (só o atual é marcado a cada ciclo); o binário sai junto com PUB_ESTADO
+static void remarcar_slot(uint slot)
+{
+    uint campo = slot % PUB_NUM_CAMPOS;
+    publicacao_marcar(slot / PUB_NUM_CAMPOS, 1u << (campo == PUB_ESTADO_BIN ? PUB_ESTADO : campo));
+}
+
+static bool transporte_mqtt(void *ctx, uint slot, const char *topico, const void *payload, uint16_t len, bool retain)
+{
+    bool telemetria = slot_telemetria(slot);
+    if (hal_mqtt_publicar(topico, payload, len, retain, telemetria ? SAIDA_TELEMETRIA : SAIDA_ESTADO))
+    {
+        return true;
+    }
+    if (!telemetria)
+    {
+        remarcar_slot(slot); // A telemetria sai de novo no próximo ciclo de qualquer forma
+    }
+    return false;
+}
@@ -0,0 +1,27 @@
+#ifndef APLICACAO_H
+#define APLICACAO_H
+
+#include "pico/stdlib.h"
+#include "comodos.h"
+
+// Lógica dos cômodos: rotas dos comandos, automação e publicações. Só fala com
+// o mundo por hal.h, então roda igual no firmware e no build do host
+// (tools/host). Quem chama garante que as funções não rodem ao mesmo tempo.
+
+extern Comodo *comodo_atual; // Cômodo selecionado por /casa/select
+
+void init_aplicacao(void); // Depois dos sensores e de init_hal()
+
+// Uma mensagem recebida (tópico sem o prefixo do dispositivo)
+void aplicacao_mensagem(const char *topico, const char *payload);
+
+// Conexão ao broker aceita: reenvia o estado retido e os valores iniciais
+void aplicacao_conectado(void);
+
+// Um ciclo do worker: sensores, automação do cômodo atual e publicações
+void aplicacao_ciclo(void);
+
+// A fila de saída descartou uma publicação já aceita: o tópico sai de novo no próximo ciclo
+void aplicacao_descartada(const char *topico);
+
+#endif
@@ -0,0 +1,277 @@
+#include "aquisicao.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#define ADC_CLOCK_HZ 48000000u
+#define ADC_CICLOS_CONVERSAO 96u
+
+static uint16_t amostras[2][AQUISICAO_MAX_AMOSTRAS]; // Ping-pong: o DMA grava um, os processadores leem o outro
+static volatile uint8_t metade = 0;                    // Buffer que o DMA está gravando
+static int canal_dma = -1;
+static uint8_t mascara_entradas;
+static uint8_t num_entradas;
+static uint8_t posicao[AQUISICAO_NUM_ENTRADAS]; // Posição de cada entrada dentro do quadro
+static uint32_t taxa_atual;
+static volatile uint janela_atual; // Em quadros (uma amostra de cada entrada)
+static volatile bool janela_cheia = false;
+static aquisicao_processador_t processadores[AQUISICAO_NUM_ENTRADAS];
+
+// Fim da janela: o DMA passa para o outro buffer. O FIFO do ADC guarda as
+// amostras enquanto o canal é rearmado, então nenhuma se perde e o round-robin
+// não sai de fase com os quadros.
+static void aquisicao_dma_irq_handler(void)
+{
+    if (!dma_channel_get_irq1_status(canal_dma))
+    {
+        return; // IRQ compartilhada: não é o nosso canal
+    }
+    dma_channel_acknowledge_irq1(canal_dma);
+    uint pronta = metade;
+    metade = pronta ^ 1;
+    janela_cheia = true;
+    dma_channel_set_write_addr(canal_dma, amostras[metade], false);
+    dma_channel_set_trans_count(canal_dma, janela_atual * num_entradas, true);
+
+    // A janela pronta só volta a ser gravada depois de uma janela inteira, que
+    // é o prazo dos processadores, qualquer que seja a taxa
+    for (uint i = 0; i < AQUISICAO_NUM_ENTRADAS; i++)
+    {
+        if (processadores[i])
+        {
+            processadores[i](&amostras[pronta][posicao[i]], janela_atual, num_entradas);
+        }
+    }
+}
+
+static void iniciar_fluxo(void)
+{
+    // O round-robin parte da entrada selecionada e segue em ordem crescente
+    uint primeira = 0;
+    while (!(mascara_entradas & (1u << primeira)))
+    {
+        primeira++;
+    }
+    adc_select_input(primeira);
+    adc_set_round_robin(num_entradas > 1 ? mascara_entradas : 0);
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_fifo_drain();
+    janela_cheia = false;
+    metade = 0;
+
+    dma_channel_config c = dma_channel_get_default_config(canal_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+    channel_config_set_read_increment(&c, false);
+    channel_config_set_write_increment(&c, true);
+    channel_config_set_dreq(&c, DREQ_ADC);
+    dma_channel_configure(canal_dma, &c, amostras[0], &adc_hw->fifo, janela_atual * num_entradas, true);
+    adc_run(true);
+}
+
+static void parar_fluxo(void)
+{
+    adc_run(false);
+    while (!(adc_hw->cs & ADC_CS_READY_BITS))
+    {
+        tight_loop_contents();
+    }
+    dma_channel_set_irq1_enabled(canal_dma, false);
+    dma_channel_abort(canal_dma);
+    dma_channel_acknowledge_irq1(canal_dma);
+    dma_channel_set_irq1_enabled(canal_dma, true);
+    adc_set_round_robin(0);
+    adc_fifo_setup(false, false, 0, false, false);
+    adc_fifo_drain();
+}
+
+// Buffer que o DMA está gravando e quantos quadros completos já tem. Vem do
+// endereço de escrita, não de `metade`, para não depender de a IRQ já ter rodado.
+static inline uint quadros_escritos(uint *buffer)
+{
+    uintptr_t addr = dma_channel_hw_addr(canal_dma)->write_addr;
+    uint b = addr >= (uintptr_t)amostras[1];
+    uint indice = (addr - (uintptr_t)amostras[b]) / sizeof(amostras[0][0]);
+    uint quadros = indice / num_entradas;
+    *buffer = b;
+    return quadros < janela_atual ? quadros : janela_atual;
+}
+
+static uint limitar_janela(uint janela)
+{
+    uint max = AQUISICAO_MAX_AMOSTRAS / num_entradas;
+    return (janela == 0) ? AQUISICAO_JANELA_PADRAO : (janela > max ? max : janela);
+}
+
+void init_aquisicao(uint8_t entradas, uint32_t taxa_hz, uint janela)
+{
+    mascara_entradas = entradas & AQUISICAO_ENTRADAS_VALIDAS;
+    if (!mascara_entradas)
+    {
+        mascara_entradas = 1;
+    }
+    num_entradas = 0;
+    for (uint i = 0; i < AQUISICAO_NUM_ENTRADAS; i++)
+    {
+        if (mascara_entradas & (1u << i))
+        {
+            posicao[i] = num_entradas++;
+        }
+    }
+    janela_atual = limitar_janela(janela);
+
+    canal_dma = dma_claim_unused_channel(true);
+    dma_channel_set_irq1_enabled(canal_dma, true);
+    irq_add_shared_handler(DMA_IRQ_1, aquisicao_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+
+    aquisicao_set_taxa(taxa_hz);
+    iniciar_fluxo();
+}
+
+void aquisicao_set_taxa(uint32_t taxa_hz)
+{
+    if (taxa_hz == 0)
+    {
+        taxa_hz = AQUISICAO_TAXA_PADRAO;
+    }
+    // Cada entrada é amostrada a taxa_hz: o ADC converte num_entradas vezes mais rápido.
+    // Período = (1 + div) ciclos do clock de 48 MHz; abaixo de 96 o ADC roda no máximo (500 kS/s)
+    uint32_t ciclos = ADC_CLOCK_HZ / (taxa_hz * num_entradas);
+    if (ciclos < ADC_CICLOS_CONVERSAO)
+    {
+        ciclos = ADC_CICLOS_CONVERSAO;
+    }
+    adc_set_clkdiv((float)(ciclos - 1));
+    taxa_atual = ADC_CLOCK_HZ / (ciclos * num_entradas);
+}
+
+bool aquisicao_set_janela(uint janela)
+{
+    if (janela == 0 || janela * num_entradas > AQUISICAO_MAX_AMOSTRAS)
+    {
+        return false;
+    }
+    parar_fluxo();
+    janela_atual = janela;
+    iniciar_fluxo();
+    return true;
+}
+
+uint32_t aquisicao_taxa(void)
+{
+    return taxa_atual;
+}
+
+uint aquisicao_janela(void)
+{
+    return janela_atual;
+}
+
+uint8_t aquisicao_entradas(void)
+{
+    return mascara_entradas;
+}
+
+void aquisicao_set_processador(uint entrada, aquisicao_processador_t fn)
+{
+    if (entrada < AQUISICAO_NUM_ENTRADAS && (mascara_entradas & (1u << entrada)))
+    {
+        processadores[entrada] = fn;
+    }
+}
+
+void aquisicao_pausar(void)
+{
+    parar_fluxo();
+}
+
+void aquisicao_retomar(void)
+{
+    iniciar_fluxo();
+}
+
+uint16_t aquisicao_ultima(uint entrada)
+{
+    if (entrada >= AQUISICAO_NUM_ENTRADAS || !(mascara_entradas & (1u << entrada)))
+    {
+        return 0;
+    }
+    uint b;
+    uint quadro = quadros_escritos(&b);
+    if (quadro == 0)
+    {
+        if (!janela_cheia)
+        {
+            return amostras[0][posicao[entrada]]; // Antes do 1º quadro devolve o índice 0
+        }
+        b ^= 1; // Buffer recém-trocado: a última amostra está no fim do outro
+        quadro = janela_atual;
+    }
+    return amostras[b][(quadro - 1) * num_entradas + posicao[entrada]];
+}
+
+uint16_t aquisicao_media(uint entrada)
+{
+    AquisicaoEstatisticas e;
+    aquisicao_estatisticas(entrada, &e);
+    return e.media;
+}
+
+void aquisicao_estatisticas(uint entrada, AquisicaoEstatisticas *e)
+{
+    // Com uma janela completa, usa a última (a que os processadores viram);
+    // antes disso, o que o DMA já gravou no primeiro buffer
+    uint b;
+    uint n = quadros_escritos(&b);
+    if (janela_cheia)
+    {
+        b = metade ^ 1;
+        n = janela_atual;
+    }
+    if (entrada >= AQUISICAO_NUM_ENTRADAS || !(mascara_entradas & (1u << entrada)) || n == 0)
+    {
+        e->ultima = e->media = e->minimo = e->maximo = 0;
+        e->amostras = 0;
+        return;
+    }
+
+    const uint16_t *p = &amostras[b][posicao[entrada]];
+    uint32_t soma = 0;
+    uint16_t minimo = 0xFFFF, maximo = 0;
+    for (uint i = 0; i < n; i++, p += num_entradas)
+    {
+        uint16_t v = *p;
+        soma += v;
+        if (v < minimo)
+            minimo = v;
+        if (v > maximo)
+            maximo = v;
+    }
+    e->ultima = aquisicao_ultima(entrada);
+    e->media = (soma + n / 2) / n;
+    e->minimo = minimo;
+    e->maximo = maximo;
+    e->amostras = n;
+}
+
+uint16_t aquisicao_ler_unica(uint entrada)
+{
+    // Pausa o modo livre só durante uma conversão (~2 µs); os buffers não são reiniciados.
+    // O round-robin é desligado para a conversão avulsa e depois retomado do ponto
+    // em que parou, preservando a fase dos quadros.
+    adc_run(false);
+    while (!(adc_hw->cs & ADC_CS_READY_BITS))
+    {
+        tight_loop_contents();
+    }
+    uint proxima = adc_get_selected_input();
+    adc_set_round_robin(0);
+    adc_fifo_setup(false, false, 0, false, false); // Esta conversão não pode ir para o FIFO
+    adc_select_input(entrada);
+    uint16_t valor = adc_read();
+    adc_select_input(proxima);
+    adc_set_round_robin(num_entradas > 1 ? mascara_entradas : 0);
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_run(true);
+    return valor;
+}
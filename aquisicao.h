@@ -0,0 +1,53 @@
+#ifndef AQUISICAO_H
+#define AQUISICAO_H
+
+#include "pico/stdlib.h"
+
+#define AQUISICAO_NUM_ENTRADAS 5      // ADC0-3 (GPIO 26-29) e sensor de temperatura
+#define AQUISICAO_ENTRADA_TEMPERATURA 4
+// ADC0-2 e temperatura. No Pico W o GPIO 29 (ADC3) é o clock do SPI do CYW43 e
+// só mede VSYS com o rádio parado; em modo livre o ADC brigaria com o Wi-Fi.
+#define AQUISICAO_ENTRADAS_VALIDAS 0x17
+#define AQUISICAO_MAX_AMOSTRAS 1024   // Tamanho de cada um dos dois buffers intercalados (todas as entradas)
+#define AQUISICAO_TAXA_PADRAO 1000    // Amostras por segundo, por entrada
+#define AQUISICAO_JANELA_PADRAO 100   // 100 amostras por entrada = 100 ms a 1 kHz
+
+typedef struct
+{
+    uint16_t ultima;
+    uint16_t media;
+    uint16_t minimo;
+    uint16_t maximo;
+    uint amostras; // Amostras válidas na janela
+} AquisicaoEstatisticas;
+
+// Chamado em contexto de interrupção a cada janela completa, com as amostras de
+// uma entrada: amostras[0], amostras[passo], ..., amostras[(n - 1) * passo].
+// A janela fica intacta até o fim da seguinte; é o prazo para processá-la.
+typedef void (*aquisicao_processador_t)(const uint16_t *amostras, uint n, uint passo);
+
+// Aquisição contínua do ADC: o conversor roda em modo livre, em round-robin
+// pelas entradas da máscara (bit i = ADC i, dentro de AQUISICAO_ENTRADAS_VALIDAS),
+// e o DMA grava os quadros intercalados em dois buffers alternados, uma janela
+// em cada. Cada entrada é lida como uma visão com passo do buffer; a CPU não
+// toca nas amostras até alguém pedir um valor.
+void init_aquisicao(uint8_t entradas, uint32_t taxa_hz, uint janela);
+void aquisicao_set_taxa(uint32_t taxa_hz);
+bool aquisicao_set_janela(uint janela);
+uint32_t aquisicao_taxa(void);
+uint aquisicao_janela(void);
+uint8_t aquisicao_entradas(void);
+void aquisicao_set_processador(uint entrada, aquisicao_processador_t processador);
+
+uint16_t aquisicao_ultima(uint entrada);
+uint16_t aquisicao_media(uint entrada);
+void aquisicao_estatisticas(uint entrada, AquisicaoEstatisticas *estatisticas);
+
+// Para o fluxo (ex.: durante gravação da flash) e o reinicia alinhado no início do primeiro buffer
+void aquisicao_pausar(void);
+void aquisicao_retomar(void);
+
+// Conversão avulsa numa entrada fora da máscara, pausando o fluxo
+uint16_t aquisicao_ler_unica(uint entrada);
+
+#endif
@@ -0,0 +1,223 @@
+#include "calibracao.h"
+#include "aquisicao.h"
+#include "hardware/flash.h"
+#include "hardware/sync.h"
+#include "nucleos.h"
+#include <stddef.h>
+#include <string.h>
+
+#if NUCLEOS_DUPLO
+#include "pico/multicore.h"
+#endif
+
+// Último setor da flash, longe do programa
+#define CALIBRACAO_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+#define CALIBRACAO_MAGICA 0x43414C31u // "CAL1"
+#define CALIBRACAO_VERSAO 1
+
+typedef struct
+{
+    uint32_t magica;
+    uint16_t versao;
+    uint16_t tamanho;
+    CalibracaoTabela tabelas[CALIBRACAO_NUM_SENSORES];
+    uint32_t soma; // Soma de verificação de tudo que vem antes
+} CalibracaoFlash;
+
+_Static_assert(sizeof(CalibracaoFlash) <= FLASH_PAGE_SIZE, "calibracao nao cabe numa pagina da flash");
+
+// Reta usada até haver calibração: a mesma da conversão original (adc 100 -> 100%, 4000 -> 0%)
+static const CalibracaoTabela tabela_padrao = {
+    .n = 2,
+    .pontos = {{100u << 2, CALIBRACAO_LUZ_MAX}, {4000u << 2, 0}},
+};
+
+static CalibracaoTabela tabelas[CALIBRACAO_NUM_SENSORES];
+static CalibracaoTabela rascunhos[CALIBRACAO_NUM_SENSORES];
+// Inclinação de cada trecho em Q16 (centésimos de % por unidade de leitura),
+// calculada uma vez para a conversão não precisar de divisão
+static int32_t inclinacoes[CALIBRACAO_NUM_SENSORES][CALIBRACAO_MAX_PONTOS - 1];
+
+static uint32_t calcular_soma(const CalibracaoFlash *dados)
+{
+    // FNV-1a: curto e suficiente para detectar setor apagado ou gravação interrompida
+    const uint8_t *p = (const uint8_t *)dados;
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < offsetof(CalibracaoFlash, soma); i++)
+    {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+static bool tabela_valida(const CalibracaoTabela *t)
+{
+    if (t->n < 2 || t->n > CALIBRACAO_MAX_PONTOS)
+    {
+        return false;
+    }
+    for (uint i = 0; i < t->n; i++)
+    {
+        if (t->pontos[i].luz > CALIBRACAO_LUZ_MAX || (i > 0 && t->pontos[i].leitura <= t->pontos[i - 1].leitura))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void preparar_tabela(uint sensor)
+{
+    const CalibracaoTabela *t = &tabelas[sensor];
+    for (uint i = 0; i + 1 < t->n; i++)
+    {
+        int32_t dy = (int32_t)t->pontos[i + 1].luz - t->pontos[i].luz;
+        int32_t dx = (int32_t)t->pontos[i + 1].leitura - t->pontos[i].leitura;
+        inclinacoes[sensor][i] = (dy * 65536) / dx;
+    }
+}
+
+void init_calibracao(void)
+{
+    const CalibracaoFlash *salvo = (const CalibracaoFlash *)(XIP_BASE + CALIBRACAO_FLASH_OFFSET);
+    bool ok = salvo->magica == CALIBRACAO_MAGICA && salvo->versao == CALIBRACAO_VERSAO &&
+              salvo->tamanho == sizeof(CalibracaoFlash) && salvo->soma == calcular_soma(salvo);
+
+    for (uint s = 0; s < CALIBRACAO_NUM_SENSORES; s++)
+    {
+        tabelas[s] = (ok && tabela_valida(&salvo->tabelas[s])) ? salvo->tabelas[s] : tabela_padrao;
+        rascunhos[s].n = 0;
+        preparar_tabela(s);
+    }
+}
+
+uint16_t calibracao_converter(uint sensor, uint16_t leitura)
+{
+    if (sensor >= CALIBRACAO_NUM_SENSORES)
+    {
+        return 0;
+    }
+    const CalibracaoTabela *t = &tabelas[sensor];
+    if (leitura <= t->pontos[0].leitura)
+    {
+        return t->pontos[0].luz;
+    }
+
+    // Tabelas curtas: a busca linear é mais barata que a binária
+    uint i = 0;
+    while (i + 2 < t->n && leitura >= t->pontos[i + 1].leitura)
+    {
+        i++;
+    }
+    if (leitura >= t->pontos[i + 1].leitura)
+    {
+        return t->pontos[i + 1].luz;
+    }
+
+    int32_t dx = leitura - t->pontos[i].leitura;
+    int32_t luz = t->pontos[i].luz + (int32_t)(((int64_t)dx * inclinacoes[sensor][i]) >> 16);
+    return luz < 0 ? 0 : luz > CALIBRACAO_LUZ_MAX ? CALIBRACAO_LUZ_MAX
+                                                   : (uint16_t)luz;
+}
+
+bool calibracao_adicionar_ponto(uint sensor, uint16_t leitura, uint16_t luz)
+{
+    if (sensor >= CALIBRACAO_NUM_SENSORES || luz > CALIBRACAO_LUZ_MAX)
+    {
+        return false;
+    }
+    CalibracaoTabela *r = &rascunhos[sensor];
+
+    // Insere mantendo a ordem; a mesma leitura substitui o ponto anterior
+    uint i = 0;
+    while (i < r->n && r->pontos[i].leitura < leitura)
+    {
+        i++;
+    }
+    if (i < r->n && r->pontos[i].leitura == leitura)
+    {
+        r->pontos[i].luz = luz;
+        return true;
+    }
+    if (r->n == CALIBRACAO_MAX_PONTOS)
+    {
+        return false;
+    }
+    memmove(&r->pontos[i + 1], &r->pontos[i], (r->n - i) * sizeof(r->pontos[0]));
+    r->pontos[i].leitura = leitura;
+    r->pontos[i].luz = luz;
+    r->n++;
+    return true;
+}
+
+uint calibracao_pontos(uint sensor)
+{
+    return sensor < CALIBRACAO_NUM_SENSORES ? rascunhos[sensor].n : 0;
+}
+
+bool calibracao_aplicar(uint sensor)
+{
+    if (sensor >= CALIBRACAO_NUM_SENSORES || !tabela_valida(&rascunhos[sensor]))
+    {
+        return false;
+    }
+    tabelas[sensor] = rascunhos[sensor];
+    rascunhos[sensor].n = 0;
+    preparar_tabela(sensor);
+    return true;
+}
+
+void calibracao_padrao(uint sensor)
+{
+    if (sensor < CALIBRACAO_NUM_SENSORES)
+    {
+        tabelas[sensor] = tabela_padrao;
+        rascunhos[sensor].n = 0;
+        preparar_tabela(sensor);
+    }
+}
+
+bool calibracao_salvar(void)
+{
+    static union
+    {
+        CalibracaoFlash dados;
+        uint8_t pagina[FLASH_PAGE_SIZE];
+    } buffer;
+
+    memset(&buffer, 0xFF, sizeof(buffer));
+    buffer.dados.magica = CALIBRACAO_MAGICA;
+    buffer.dados.versao = CALIBRACAO_VERSAO;
+    buffer.dados.tamanho = sizeof(CalibracaoFlash);
+    memcpy(buffer.dados.tabelas, tabelas, sizeof(tabelas));
+    buffer.dados.soma = calcular_soma(&buffer.dados);
+
+    // Com a XIP desligada nenhuma interrupção pode rodar da flash. O fluxo do
+    // ADC é pausado antes: sem a IRQ do DMA o FIFO transbordaria e o
+    // round-robin sairia de fase com os quadros.
+    // Com NUCLEOS_DUPLO o outro núcleo também roda da flash: ele fica preso num
+    // laço na RAM durante a gravação (a única espera entre os núcleos)
+    aquisicao_pausar();
+#if NUCLEOS_DUPLO
+    multicore_lockout_start_blocking();
+#endif
+    uint32_t ints = save_and_disable_interrupts();
+    flash_range_erase(CALIBRACAO_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(CALIBRACAO_FLASH_OFFSET, buffer.pagina, FLASH_PAGE_SIZE);
+    restore_interrupts(ints);
+#if NUCLEOS_DUPLO
+    multicore_lockout_end_blocking();
+#endif
+    aquisicao_retomar();
+
+    const CalibracaoFlash *salvo = (const CalibracaoFlash *)(XIP_BASE + CALIBRACAO_FLASH_OFFSET);
+    return memcmp(salvo, &buffer.dados, sizeof(CalibracaoFlash)) == 0;
+}
+
+void calibracao_tabela(uint sensor, CalibracaoTabela *tabela)
+{
+    if (sensor < CALIBRACAO_NUM_SENSORES)
+    {
+        *tabela = tabelas[sensor];
+    }
+}
@@ -0,0 +1,39 @@
+#ifndef CALIBRACAO_H
+#define CALIBRACAO_H
+
+#include "pico/stdlib.h"
+
+#define CALIBRACAO_NUM_SENSORES 3 // Um por entrada de LDR (ADC0-2)
+#define CALIBRACAO_MAX_PONTOS 8
+#define CALIBRACAO_LUZ_MAX 10000  // Luz em centésimos de porcento (0-100,00%)
+
+// Ponto medido: leitura do LDR (na escala do filtro, 14 bits) -> luz de referência
+typedef struct
+{
+    uint16_t leitura;
+    uint16_t luz; // Centésimos de porcento
+} CalibracaoPonto;
+
+typedef struct
+{
+    uint8_t n;
+    CalibracaoPonto pontos[CALIBRACAO_MAX_PONTOS]; // Ordenados por leitura crescente
+} CalibracaoTabela;
+
+// Carrega as tabelas da flash; sem dados válidos usa a reta padrão (adc 100-4000)
+void init_calibracao(void);
+
+// Leitura -> luz por interpolação linear por trechos, só com inteiros.
+// Fora da faixa calibrada devolve o valor da ponta mais próxima.
+uint16_t calibracao_converter(uint sensor, uint16_t leitura);
+
+// Calibração em duas fases: os pontos vão para um rascunho e só substituem a
+// tabela ativa em calibracao_aplicar(), então a conversão nunca vê meia tabela.
+bool calibracao_adicionar_ponto(uint sensor, uint16_t leitura, uint16_t luz);
+uint calibracao_pontos(uint sensor);          // Pontos no rascunho
+bool calibracao_aplicar(uint sensor);         // Exige ao menos 2 pontos
+void calibracao_padrao(uint sensor);          // Volta à reta padrão e descarta o rascunho
+bool calibracao_salvar(void);                 // Grava as tabelas ativas na flash
+void calibracao_tabela(uint sensor, CalibracaoTabela *tabela);
+
+#endif
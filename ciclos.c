@@ -0,0 +1,38 @@
+#include "ciclos.h"
+#include "hardware/structs/systick.h"
+
+#define SYSTICK_RECARGA 0xFFFFFFu
+#define SYSTICK_CSR_ATIVO 0x1u
+#define SYSTICK_CSR_INTERRUPCAO 0x2u
+#define SYSTICK_CSR_CLOCK_CPU 0x4u
+#define SYSTICK_CSR_ESTOURO 0x10000u
+
+// O SysTick é de cada núcleo: cada um conta os próprios estouros
+static volatile uint32_t estouros[NUM_CORES];
+
+// Substitui o handler fraco do SDK
+void isr_systick(void)
+{
+    estouros[get_core_num()]++;
+}
+
+void init_ciclos(void)
+{
+    systick_hw->csr = 0;
+    systick_hw->rvr = SYSTICK_RECARGA;
+    systick_hw->cvr = 0;
+    systick_hw->csr = SYSTICK_CSR_ATIVO | SYSTICK_CSR_INTERRUPCAO | SYSTICK_CSR_CLOCK_CPU;
+}
+
+uint64_t ciclos_agora(void)
+{
+    // O SysTick conta para baixo; relê se um estouro aconteceu no meio da leitura
+    volatile uint32_t *contador = &estouros[get_core_num()];
+    uint32_t antes, valor;
+    do
+    {
+        antes = *contador;
+        valor = systick_hw->cvr;
+    } while (antes != *contador);
+    return ((uint64_t)antes << 24) + (SYSTICK_RECARGA - valor);
+}
@@ -0,0 +1,30 @@
+#ifndef CICLOS_H
+#define CICLOS_H
+
+#include "pico/stdlib.h"
+
+// Contador de ciclos do processador sobre o SysTick (24 bits, estendido para
+// 64 bits pela interrupção de estouro, uma a cada ~134 ms a 125 MHz). Cada
+// núcleo tem o seu SysTick: init_ciclos() vale para o núcleo que a chamou.
+void init_ciclos(void);
+uint64_t ciclos_agora(void);
+
+// Ciclos gastos num trecho (ex.: um passo do worker)
+typedef struct
+{
+    uint64_t inicio;
+    uint64_t total;
+} CiclosMedida;
+
+static inline void ciclos_iniciar(CiclosMedida *m)
+{
+    m->inicio = ciclos_agora();
+}
+
+static inline uint32_t ciclos_terminar(CiclosMedida *m)
+{
+    m->total = ciclos_agora() - m->inicio;
+    return (uint32_t)m->total;
+}
+
+#endif
@@ -0,0 +1,44 @@
+#ifndef COMODO_H
+#define COMODO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "controle.h"
+
+// Tópicos de publicação de um cômodo, montados em tempo de compilação (comodos.c)
+typedef struct
+{
+    const char *estado;
+    const char *estado_bin;
+    const char *luz;
+    const char *luz_estado;
+    const char *janela_pos;
+    const char *janela_estado;
+    const char *calibrar_estado;
+    const char *controle_estado;
+    const char *modo;
+    const char *modo_dormir;
+    const char *luz_set;
+} ComodoTopicos;
+
+// Porcentagens em centésimos (0-10000 = 0-100,00%): inteiros na CPU sem FPU,
+// comparação exata e o mesmo texto "%.2f" nos tópicos
+#define COMODO_PORCENTO(p) ((uint16_t)((p) * 100))
+#define COMODO_100_PORCENTO COMODO_PORCENTO(100)
+
+// Estado de um cômodo
+typedef struct
+{
+    const char *nome;      // Ex.: "sala"
+    const ComodoTopicos *topicos;
+    uint16_t iluminacao_alvo; // Ex.: 6500 = 65% (ajustável pelo usuário)
+    uint16_t janela_pos;      // Abertura, 0-10000
+    uint16_t luz;             // Última iluminação medida pelo LDR, 0-10000
+    bool luz_ligada;       // Luz on/off
+    bool modo_auto;        // Automático ou manual
+    bool modo_dormir;      // Modo dormir ativo
+    uint8_t ldr_entradas;  // LDRs do cômodo (bit i = ADC i); a luz é a média deles
+    Controle controle;     // Controlador do modo automático, com ganhos próprios
+} Comodo;
+
+#endif
@@ -0,0 +1,53 @@
+#include "comodos.h"
+
+// Tópicos internados: concatenação de literais, sem formatação em tempo de execução
+#define COMODO_TOPICOS(id, nome, ldr)                         \
+    static const ComodoTopicos topicos_##id = {               \
+        .estado = "/casa/" nome "/estado",                    \
+        .estado_bin = "/casa/" nome "/estado/bin",            \
+        .luz = "/casa/" nome "/luz",                          \
+        .luz_estado = "/casa/" nome "/luz/estado",            \
+        .janela_pos = "/casa/" nome "/janela/pos",            \
+        .janela_estado = "/casa/" nome "/janela/estado",      \
+        .calibrar_estado = "/casa/" nome "/calibrar/estado",  \
+        .controle_estado = "/casa/" nome "/controle/estado",  \
+        .modo = "/casa/" nome "/modo",                        \
+        .modo_dormir = "/casa/" nome "/modo_dormir",          \
+        .luz_set = "/casa/" nome "/luz/set",                  \
+    };
+COMODOS(COMODO_TOPICOS)
+#undef COMODO_TOPICOS
+
+#define COMODO_ESTADO(id, nome_, ldr)                  \
+    [COMODO_##id] = {                                  \
+        .nome = nome_,                                 \
+        .topicos = &topicos_##id,                      \
+        .iluminacao_alvo = COMODO_ILUMINACAO_ALVO,     \
+        .janela_pos = 0,                               \
+        .luz_ligada = false,                           \
+        .modo_auto = true,                             \
+        .modo_dormir = false,                          \
+        .ldr_entradas = (ldr),                         \
+        .controle = CONTROLE_PADRAO,                   \
+    },
+Comodo comodos_estado[NUM_COMODOS] = {COMODOS(COMODO_ESTADO)};
+#undef COMODO_ESTADO
+
+#define COMODO_PONTEIRO(id, nome, ldr) [COMODO_##id] = &comodos_estado[COMODO_##id],
+Comodo *const comodos[NUM_COMODOS] = {COMODOS(COMODO_PONTEIRO)};
+#undef COMODO_PONTEIRO
+
+#define COMODO_ASSINATURA(nome, handler, caminho) "/casa/" nome "/" caminho,
+#define COMODO_ASSINATURAS(id, nome, ldr) COMODO_COMANDOS(COMODO_ASSINATURA, nome)
+const char *const comodos_assinaturas[] = {COMODOS(COMODO_ASSINATURAS)};
+#undef COMODO_ASSINATURAS
+#undef COMODO_ASSINATURA
+
+const uint comodos_num_assinaturas = count_of(comodos_assinaturas);
+
+// Um filtro por comando, valendo para todos os cômodos
+#define COMODO_ASSINATURA_CURINGA(nome, handler, caminho) "/casa/+/" caminho,
+const char *const comodos_assinaturas_curinga[] = {COMODO_COMANDOS(COMODO_ASSINATURA_CURINGA, "")};
+#undef COMODO_ASSINATURA_CURINGA
+
+const uint comodos_num_assinaturas_curinga = count_of(comodos_assinaturas_curinga);
@@ -0,0 +1,44 @@
+#ifndef COMODOS_H
+#define COMODOS_H
+
+#include "pico/stdlib.h"
+#include "comodo.h"
+#include "sensores.h"
+
+#define COMODO_ILUMINACAO_ALVO COMODO_PORCENTO(65) // Iluminação padrão (65%)
+
+// Tabela dos cômodos: adicionar um cômodo é adicionar uma linha.
+// Campos: identificador C, nome usado nos tópicos, LDRs do cômodo (bit i = ADC i)
+#define COMODOS(X)                               \
+    X(sala, "sala", SENSORES_ENTRADAS_LDR)       \
+    X(quarto1, "quarto1", SENSORES_ENTRADAS_LDR)
+
+// Comandos aceitos em /casa/<comodo>/<caminho>: handler (em aplicacao.c) e caminho.
+// Geram a tabela de rotas e a lista de assinaturas de cada cômodo.
+#define COMODO_COMANDOS(X, nome)               \
+    X(nome, rota_luz_set, "luz/set")           \
+    X(nome, rota_janela_set, "janela/set")     \
+    X(nome, rota_janela_abrir, "janela/abrir") \
+    X(nome, rota_luz_ligar, "luz/ligar")       \
+    X(nome, rota_modo, "modo")                 \
+    X(nome, rota_modo_dormir, "modo_dormir")   \
+    X(nome, rota_calibrar, "calibrar")         \
+    X(nome, rota_controle, "controle")
+
+enum
+{
+#define COMODO_ENUM(id, nome, ldr) COMODO_##id,
+    COMODOS(COMODO_ENUM)
+#undef COMODO_ENUM
+    NUM_COMODOS
+};
+
+// Estados e tópicos de todos os cômodos, gerados a partir de COMODOS
+extern Comodo comodos_estado[NUM_COMODOS];
+extern Comodo *const comodos[NUM_COMODOS];
+extern const char *const comodos_assinaturas[]; // "/casa/<comodo>/<caminho>" de cada comando
+extern const uint comodos_num_assinaturas;
+extern const char *const comodos_assinaturas_curinga[]; // "/casa/+/<caminho>" de cada comando
+extern const uint comodos_num_assinaturas_curinga;
+
+#endif
@@ -0,0 +1,232 @@
+#include "controle.h"
+#include <string.h>
+#include "formato.h"
+
+#define CONTROLE_POS_MAX 10000
+
+static inline int32_t limitar(int32_t v, int32_t min, int32_t max)
+{
+    return v < min ? min : (v > max ? max : v);
+}
+
+static inline int32_t limitar64(int64_t v, int32_t min, int32_t max)
+{
+    return v < min ? min : (v > max ? max : (int32_t)v);
+}
+
+void controle_reiniciar(Controle *c, uint32_t agora_ms)
+{
+    c->integral = 0;
+    c->luz_anterior = -1;
+    c->condicao = false;
+    c->troca_ms = agora_ms - CONTROLE_PERMANENCIA_MS; // A lâmpada pode trocar já no primeiro passo
+    c->medindo = false;
+    c->medida_nova = false;
+}
+
+// Reestima o modelo com a resposta ao último passo: só um atuador pode ter mexido
+static void atualizar_modelo(Controle *c, int32_t luz, uint16_t pos, bool lampada)
+{
+    int32_t dluz = luz - c->luz_anterior;
+    int32_t dpos = (int32_t)pos - c->pos_anterior;
+    if (lampada != c->lampada_anterior)
+    {
+        // A janela compensou a troca: desconta a parte dela pelo ganho atual
+        int32_t medido = dluz - (int32_t)(((int64_t)c->ganho_planta * dpos) >> 16);
+        medido = lampada ? medido : -medido;
+        if (medido > 0)
+        {
+            c->luz_lampada += (medido - c->luz_lampada) / 2;
+        }
+        return;
+    }
+    if (dpos >= CONTROLE_DEGRAU_MIN || dpos <= -CONTROLE_DEGRAU_MIN)
+    {
+        // Um ganho negativo é ruído ou a luz do dia mudando no meio; um ganho
+        // quase nulo (noite, amanhecer) é real e precisa entrar no modelo
+        int32_t medido = (int32_t)(((int64_t)dluz << 16) / dpos);
+        if (medido > 0)
+        {
+            medido = limitar(medido, CONTROLE_GANHO_PLANTA_MIN, CONTROLE_GANHO_PLANTA_MAX);
+            c->ganho_planta += (medido - c->ganho_planta) / 4;
+        }
+    }
+}
+
+// Acomodação: primeiro instante a partir do qual o erro fica na tolerância por CONTROLE_CONFIRMACAO_MS
+static void medir_resposta(Controle *c, int32_t luz, uint16_t alvo, uint32_t agora_ms)
+{
+    int32_t erro = (int32_t)alvo - luz;
+    if (!c->medindo || alvo != c->alvo_degrau)
+    {
+        c->medindo = erro > CONTROLE_TOLERANCIA || erro < -CONTROLE_TOLERANCIA;
+        c->sentido = erro > 0 ? 1 : -1;
+        c->alvo_degrau = alvo;
+        c->degrau_ms = agora_ms;
+        c->dentro_ms = 0;
+        c->sobressinal = 0;
+        return;
+    }
+
+    int32_t passou = -erro * c->sentido;
+    if (passou > c->sobressinal)
+    {
+        c->sobressinal = passou;
+    }
+    if (erro > CONTROLE_TOLERANCIA || erro < -CONTROLE_TOLERANCIA)
+    {
+        c->dentro_ms = 0;
+    }
+    else if (c->dentro_ms == 0)
+    {
+        c->dentro_ms = agora_ms;
+    }
+    else if (agora_ms - c->dentro_ms >= CONTROLE_CONFIRMACAO_MS)
+    {
+        c->acomodacao_ms = c->dentro_ms - c->degrau_ms;
+        c->sobressinal_medido = c->sobressinal;
+        c->medindo = false;
+        c->medida_nova = true;
+    }
+}
+
+// Condição de troca que precisa durar CONTROLE_CONFIRMACAO_MS, respeitando a permanência
+static bool confirmar_troca(Controle *c, bool condicao, uint32_t agora_ms)
+{
+    if (!condicao)
+    {
+        c->condicao = false;
+        return false;
+    }
+    if (!c->condicao)
+    {
+        c->condicao = true;
+        c->condicao_ms = agora_ms;
+    }
+    if (agora_ms - c->condicao_ms < CONTROLE_CONFIRMACAO_MS || agora_ms - c->troca_ms < CONTROLE_PERMANENCIA_MS)
+    {
+        return false;
+    }
+    c->condicao = false;
+    c->troca_ms = agora_ms;
+    c->integral = 0;
+    return true;
+}
+
+ControleAcao controle_passo(Controle *c, uint16_t luz, uint16_t alvo, uint16_t janela_pos, bool luz_ligada, uint32_t agora_ms)
+{
+    ControleAcao acao = {janela_pos, luz_ligada};
+    int32_t erro = (int32_t)alvo - luz;
+    bool primeiro = c->luz_anterior < 0;
+    uint32_t dt_ms = primeiro ? 0 : agora_ms - c->anterior_ms;
+
+    c->medida_nova = false;
+    if (!primeiro)
+    {
+        atualizar_modelo(c, luz, janela_pos, luz_ligada);
+    }
+    medir_resposta(c, luz, alvo, agora_ms);
+
+    // Janela: feed-forward pelo modelo + PID. A base é a luz com a janela fechada
+    // e a lâmpada apagada; a lâmpada acesa entra como uma parcela conhecida
+    int32_t lampada = luz_ligada ? c->luz_lampada : 0;
+    int32_t base = (int32_t)luz - lampada - (int32_t)(((int64_t)c->ganho_planta * janela_pos) >> 16);
+    c->base = primeiro ? base : c->base + (base - c->base) / 4;
+    // Com o ganho da planta no mínimo, o produto passa de 32 bits: limita só no fim
+    int32_t ff = limitar64(((int64_t)alvo - c->base - lampada) * 65536 / c->ganho_planta * c->kff / 100,
+                           -CONTROLE_POS_MAX, CONTROLE_POS_MAX);
+    int32_t p = erro * c->kp / 100;
+    int32_t d = 0;
+    if (dt_ms > 0)
+    {
+        // Derivada sobre a medida (não sobre o erro), para não dar coice na mudança de alvo
+        d = limitar64((int64_t)(c->luz_anterior - (int32_t)luz) * c->kd * 10 / (int32_t)dt_ms,
+                      -CONTROLE_POS_MAX, CONTROLE_POS_MAX);
+    }
+    int32_t livre = ff + p + d;
+    int32_t saida = livre + c->integral / 100;
+
+    // Anti-windup: não integra quando a saída está saturada e o erro empurra para fora;
+    // o limite de movimento por passo também conta como saturação
+    int32_t minimo = limitar((int32_t)janela_pos - CONTROLE_MOVIMENTO_MAX, 0, CONTROLE_POS_MAX);
+    int32_t maximo = limitar((int32_t)janela_pos + CONTROLE_MOVIMENTO_MAX, 0, CONTROLE_POS_MAX);
+    bool saturada_alta = saida >= maximo && erro > 0;
+    bool saturada_baixa = saida <= minimo && erro < 0;
+    if (dt_ms > 0 && !saturada_alta && !saturada_baixa)
+    {
+        int64_t integral = c->integral + (int64_t)erro * c->ki * dt_ms / 1000;
+        c->integral = limitar64(integral, -CONTROLE_POS_MAX * 100, CONTROLE_POS_MAX * 100);
+        saida = livre + c->integral / 100;
+    }
+    saida = limitar(saida, minimo, maximo);
+
+    // Zona morta: o ruído do LDR não mexe no servo; os extremos sempre são alcançados
+    int32_t movimento = saida - (int32_t)janela_pos;
+    if (movimento >= CONTROLE_MOVIMENTO_MIN || movimento <= -CONTROLE_MOVIMENTO_MIN || saida == 0 || saida == CONTROLE_POS_MAX)
+    {
+        acao.janela_pos = (uint16_t)saida;
+    }
+
+    // Lâmpada: acende só com a janela toda aberta e faltando luz; apaga quando a
+    // luz natural com a janela toda aberta (estimada pelo modelo) quase basta
+    bool trocar;
+    if (luz_ligada)
+    {
+        int32_t natural = (int32_t)luz - lampada + (int32_t)(((int64_t)c->ganho_planta * (CONTROLE_POS_MAX - janela_pos)) >> 16);
+        trocar = natural >= (int32_t)alvo - CONTROLE_HISTERESE_DESLIGAR;
+    }
+    else
+    {
+        trocar = janela_pos >= CONTROLE_POS_MAX && erro > CONTROLE_HISTERESE_LIGAR;
+    }
+    if (confirmar_troca(c, trocar, agora_ms))
+    {
+        // Feed-forward da troca: a janela já anda o equivalente à lâmpada pelo modelo
+        int32_t compensacao = (int32_t)(((int64_t)c->luz_lampada << 16) / c->ganho_planta);
+        acao.luz_ligada = !luz_ligada;
+        acao.janela_pos = (uint16_t)limitar((int32_t)janela_pos + (luz_ligada ? compensacao : -compensacao), 0, CONTROLE_POS_MAX);
+    }
+
+    c->luz_anterior = luz;
+    c->pos_anterior = janela_pos;
+    c->lampada_anterior = luz_ligada;
+    c->anterior_ms = agora_ms;
+    return acao;
+}
+
+bool controle_ler_ganhos(Controle *c, const char *texto)
+{
+    static const char *const chaves[] = {"kp=", "ki=", "kd=", "ff="};
+    int16_t *ganhos[] = {&c->kp, &c->ki, &c->kd, &c->kff};
+    bool algum = false;
+    for (uint i = 0; i < count_of(chaves); i++)
+    {
+        const char *p = strstr(texto, chaves[i]);
+        int32_t valor;
+        if (p && formato_ler_centesimos(p + 3, &valor) && valor >= 0 && valor <= CONTROLE_GANHO_MAX)
+        {
+            *ganhos[i] = (int16_t)valor;
+            algum = true;
+        }
+    }
+    if (algum)
+    {
+        c->integral = 0;
+    }
+    return algum;
+}
+
+size_t controle_descrever(const Controle *c, char *buf, size_t tam)
+{
+    Json json;
+    json_abrir(&json, buf, tam);
+    json_centesimos(&json, "kp", c->kp);
+    json_centesimos(&json, "ki", c->ki);
+    json_centesimos(&json, "kd", c->kd);
+    json_centesimos(&json, "ff", c->kff);
+    json_centesimos(&json, "ganho_planta", (int32_t)(((int64_t)c->ganho_planta * 100 + (1 << 15)) >> 16));
+    json_centesimos(&json, "luz_lampada", c->luz_lampada);
+    json_inteiro(&json, "acomodacao_ms", (int32_t)c->acomodacao_ms);
+    json_centesimos(&json, "sobressinal", c->sobressinal_medido);
+    return json_fechar(&json);
+}
@@ -0,0 +1,97 @@
+#ifndef CONTROLE_H
+#define CONTROLE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Ganhos padrão em centésimos (100 = 1,00); configuráveis por cômodo pelo MQTT
+#define CONTROLE_KP 10  // Posição por unidade de erro de luz
+#define CONTROLE_KI 10  // Idem, por segundo de erro acumulado
+#define CONTROLE_KD 0   // Idem, pela variação da luz medida por segundo
+#define CONTROLE_KFF 100 // Peso do feed-forward pelo modelo medido (0 desliga)
+#define CONTROLE_GANHO_MAX 1000 // Maior ganho aceito pelo MQTT (10,00)
+
+// Faixas em centésimos de porcento
+#define CONTROLE_TOLERANCIA 200         // |erro| <= 2% conta como no alvo
+#define CONTROLE_MOVIMENTO_MIN 200      // Menor movimento da janela (zona morta contra o ruído)
+#define CONTROLE_MOVIMENTO_MAX 2500     // Maior movimento da janela por passo: o ganho é remedido no caminho
+#define CONTROLE_HISTERESE_LIGAR 500    // Falta de luz, com a janela toda aberta, para acender a lâmpada
+#define CONTROLE_HISTERESE_DESLIGAR 200 // Luz natural que pode faltar ao apagar (menor que a de ligar)
+#define CONTROLE_CONFIRMACAO_MS 4000    // Tempo que a condição de troca da lâmpada precisa durar
+#define CONTROLE_PERMANENCIA_MS 30000   // Tempo mínimo entre duas trocas da lâmpada
+
+// Modelo da planta, aprendido com as respostas medidas
+#define CONTROLE_GANHO_PLANTA_PADRAO (1 << 16) // Luz por abertura da janela em Q16 (1,0); subestima a abertura no 1º passo
+#define CONTROLE_GANHO_PLANTA_MIN (1 << 10)    // 0,016
+#define CONTROLE_GANHO_PLANTA_MAX (4 << 16)
+#define CONTROLE_LUZ_LAMPADA_PADRAO 3000       // Contribuição da lâmpada (30%)
+#define CONTROLE_DEGRAU_MIN 1000               // Menor movimento da janela usado para medir o ganho
+
+// Controlador da janela e da lâmpada de um cômodo. A janela segue um PID com
+// feed-forward: o modelo luz = base + ganho * abertura é reestimado a cada
+// movimento, e a parcela do modelo leva a janela perto do alvo num só passo;
+// o PID corrige o que o modelo erra. A lâmpada é um segundo estágio: só acende
+// com a janela toda aberta, e liga/desliga com histerese e permanência mínima;
+// acesa, a janela continua regulando para não passar do alvo.
+typedef struct
+{
+    int16_t kp, ki, kd, kff; // Centésimos
+
+    int32_t integral;     // Parcela integral, em centésimos de posição x 100
+    int32_t luz_anterior; // -1 antes da primeira medida
+    uint16_t pos_anterior;
+    bool lampada_anterior;
+    uint32_t anterior_ms;
+
+    int32_t ganho_planta; // Q16
+    int32_t base;         // Luz estimada com a janela fechada (filtrada), centésimos
+    int32_t luz_lampada;  // Centésimos
+
+    uint32_t troca_ms;    // Última troca da lâmpada
+    bool condicao;        // A condição de troca da lâmpada vale desde condicao_ms
+    uint32_t condicao_ms;
+
+    // Medição da resposta ao último degrau (mudança de alvo ou início do automático)
+    bool medindo;
+    bool medida_nova;     // Uma medição terminou neste passo
+    int16_t sentido;      // +1 subindo até o alvo, -1 descendo
+    uint16_t alvo_degrau;
+    uint32_t degrau_ms;
+    uint32_t dentro_ms;   // Entrada na faixa de tolerância (0 = fora)
+    int32_t sobressinal;  // Maior ultrapassagem do alvo, em centésimos
+    uint32_t acomodacao_ms; // Última medição concluída
+    int32_t sobressinal_medido;
+} Controle;
+
+#define CONTROLE_PADRAO                             \
+    {                                               \
+        .kp = CONTROLE_KP,                          \
+        .ki = CONTROLE_KI,                          \
+        .kd = CONTROLE_KD,                          \
+        .kff = CONTROLE_KFF,                        \
+        .luz_anterior = -1,                         \
+        .ganho_planta = CONTROLE_GANHO_PLANTA_PADRAO, \
+        .luz_lampada = CONTROLE_LUZ_LAMPADA_PADRAO, \
+    }
+
+// Comando para os atuadores; o chamador aplica só o que mudou
+typedef struct
+{
+    uint16_t janela_pos;
+    bool luz_ligada;
+} ControleAcao;
+
+// Zera o estado dinâmico (ex.: ao entrar no modo automático); mantém ganhos e modelo
+void controle_reiniciar(Controle *c, uint32_t agora_ms);
+
+// Um passo do controle com a luz medida, o alvo e a posição atual dos atuadores
+ControleAcao controle_passo(Controle *c, uint16_t luz, uint16_t alvo, uint16_t janela_pos, bool luz_ligada, uint32_t agora_ms);
+
+// "kp=0.3 ki=0.1 kd=0 ff=1": altera só os ganhos presentes; false se nenhum foi reconhecido
+bool controle_ler_ganhos(Controle *c, const char *texto);
+
+// JSON com ganhos, modelo e a última medição de acomodação/sobressinal
+size_t controle_descrever(const Controle *c, char *buf, size_t tam);
+
+#endif
@@ -0,0 +1,26 @@
+#include "estado_bin.h"
+
+static inline uint16_t limitar(uint16_t centesimos)
+{
+    return centesimos > COMODO_100_PORCENTO ? COMODO_100_PORCENTO : centesimos;
+}
+
+void estado_bin_codificar(EstadoBin *bin, const Comodo *comodo, uint16_t luz, float temperatura)
+{
+    bin->versao = ESTADO_BIN_VERSAO;
+    bin->flags = (comodo->luz_ligada ? ESTADO_BIN_LUZ_LIGADA : 0) |
+                 (comodo->modo_auto ? ESTADO_BIN_MODO_AUTO : 0) |
+                 (comodo->modo_dormir ? ESTADO_BIN_MODO_DORMIR : 0);
+    bin->luz = limitar(luz);
+    bin->janela = limitar(comodo->janela_pos);
+    bin->alvo = limitar(comodo->iluminacao_alvo);
+    if (temperatura != temperatura)
+    {
+        bin->temperatura = ESTADO_BIN_SEM_TEMPERATURA; // NaN passaria pelas duas comparações abaixo
+        return;
+    }
+    float t = temperatura * 100.0f;
+    t = t < INT16_MIN + 1 ? INT16_MIN + 1 : t > INT16_MAX ? INT16_MAX
+                                                          : t;
+    bin->temperatura = (int16_t)(t < 0.0f ? t - 0.5f : t + 0.5f);
+}
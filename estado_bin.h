@@ -0,0 +1,32 @@
+#ifndef ESTADO_BIN_H
+#define ESTADO_BIN_H
+
+#include "pico/stdlib.h"
+#include "comodo.h"
+
+#define ESTADO_BIN_VERSAO 1
+
+#define ESTADO_BIN_LUZ_LIGADA (1u << 0)
+#define ESTADO_BIN_MODO_AUTO (1u << 1)
+#define ESTADO_BIN_MODO_DORMIR (1u << 2)
+#define ESTADO_BIN_SEM_TEMPERATURA INT16_MIN // Leitura inválida (NaN)
+
+// Estado completo de um cômodo em /casa/<comodo>/estado/bin. Little-endian,
+// sem preenchimento; porcentagens e temperatura em centésimos. Campos novos só
+// entram no fim, com ESTADO_BIN_VERSAO incrementada.
+// Decodificador/ponte para os tópicos de texto: tools/estado_bin_bridge.py
+typedef struct __attribute__((packed))
+{
+    uint8_t versao;
+    uint8_t flags;          // ESTADO_BIN_*
+    uint16_t luz;           // Iluminação medida, 0-10000
+    uint16_t janela;        // Abertura da janela, 0-10000
+    uint16_t alvo;          // Iluminação-alvo, 0-10000
+    int16_t temperatura;    // Temperatura interna, centésimos de TEMPERATURE_UNITS; ESTADO_BIN_SEM_TEMPERATURA sem leitura
+} EstadoBin;
+
+_Static_assert(sizeof(EstadoBin) == 10, "EstadoBin mudou de tamanho: incremente ESTADO_BIN_VERSAO");
+
+void estado_bin_codificar(EstadoBin *bin, const Comodo *comodo, uint16_t luz, float temperatura);
+
+#endif
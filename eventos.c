@@ -0,0 +1,116 @@
+#include "eventos.h"
+#include "pico/async_context.h"
+#include "hardware/sync.h"
+
+static EventosAssinante *assinantes[EVENTOS_MAX_ASSINANTES];
+static uint num_assinantes;
+// Produtores em interrupções e nos dois núcleos: trava de hardware
+static spin_lock_t *trava;
+
+static uint64_t latencia_soma_us;
+static EventosLatencia latencia;
+
+void init_eventos(void)
+{
+    trava = spin_lock_instance(spin_lock_claim_unused(true));
+}
+
+bool eventos_assinar(EventosAssinante *a, uint32_t eventos, async_context_t *contexto, async_when_pending_worker_t *worker)
+{
+    a->mascara = eventos;
+    a->pendentes = 0;
+    a->contexto = contexto;
+    a->worker = worker;
+    if (worker)
+    {
+        async_context_add_when_pending_worker(contexto, worker);
+    }
+
+    uint32_t irq = spin_lock_blocking(trava);
+    bool ok = num_assinantes < EVENTOS_MAX_ASSINANTES;
+    if (ok)
+    {
+        assinantes[num_assinantes++] = a;
+    }
+    spin_unlock(trava, irq);
+    return ok;
+}
+
+void eventos_postar(uint32_t eventos)
+{
+    uint64_t agora = time_us_64();
+    EventosAssinante *acordar[EVENTOS_MAX_ASSINANTES];
+    uint n = 0;
+    bool sev = false;
+
+    uint32_t irq = spin_lock_blocking(trava);
+    for (uint i = 0; i < num_assinantes; i++)
+    {
+        EventosAssinante *a = assinantes[i];
+        uint32_t novos = eventos & a->mascara;
+        if (!novos)
+        {
+            continue;
+        }
+        if (!a->pendentes)
+        {
+            a->postado_us = agora;
+        }
+        a->pendentes |= novos;
+        if (a->worker)
+        {
+            acordar[n++] = a;
+        }
+        else
+        {
+            sev = true;
+        }
+    }
+    spin_unlock(trava, irq);
+
+    // Fora da trava: o async_context tem as próprias travas
+    for (uint i = 0; i < n; i++)
+    {
+        async_context_set_work_pending(acordar[i]->contexto, acordar[i]->worker);
+    }
+    if (sev)
+    {
+        __sev();
+    }
+}
+
+uint32_t eventos_retirar(EventosAssinante *a, uint64_t *postado_us)
+{
+    uint32_t irq = spin_lock_blocking(trava);
+    uint32_t pendentes = a->pendentes;
+    a->pendentes = 0;
+    if (postado_us)
+    {
+        *postado_us = a->postado_us;
+    }
+    spin_unlock(trava, irq);
+    return pendentes;
+}
+
+void eventos_registrar_latencia(uint64_t postado_us)
+{
+    uint32_t us = (uint32_t)(time_us_64() - postado_us);
+    uint32_t irq = spin_lock_blocking(trava);
+    latencia.amostras++;
+    latencia_soma_us += us;
+    if (us > latencia.max_us)
+    {
+        latencia.max_us = us;
+    }
+    spin_unlock(trava, irq);
+}
+
+void eventos_latencia(EventosLatencia *l)
+{
+    uint32_t irq = spin_lock_blocking(trava);
+    latencia.media_us = latencia.amostras ? (uint32_t)(latencia_soma_us / latencia.amostras) : 0;
+    *l = latencia;
+    latencia = (EventosLatencia){0};
+    latencia_soma_us = 0;
+    spin_unlock(trava, irq);
+}
@@ -0,0 +1,58 @@
+#ifndef EVENTOS_H
+#define EVENTOS_H
+
+#include "pico/stdlib.h"
+
+// Eventos do sistema: quem muda o estado posta (comandos MQTT, ciclo do
+// controle, botão) e quem o mostra assina (matriz, painel). Os eventos de um
+// assinante se acumulam numa máscara até ele os retirar, então rajadas viram
+// um só redesenho, sempre com o estado mais recente.
+enum
+{
+    EVENTO_COMODO = 1u << 0, // Cômodo selecionado
+    EVENTO_JANELA = 1u << 1, // Abertura da janela
+    EVENTO_LUZ = 1u << 2,    // Lâmpada
+    EVENTO_MODO = 1u << 3,   // Modo, modo dormir ou iluminação-alvo
+    EVENTO_MEDIDA = 1u << 4, // Nova leitura de luz (ciclo do controle)
+    EVENTO_BOTAO = 1u << 5,
+};
+#define EVENTOS_ESTADO (EVENTO_COMODO | EVENTO_JANELA | EVENTO_LUZ | EVENTO_MODO | EVENTO_MEDIDA)
+#define EVENTOS_MAX_ASSINANTES 4
+
+struct async_context;
+struct async_when_pending_worker;
+
+typedef struct
+{
+    uint32_t mascara;
+    volatile uint32_t pendentes;
+    uint64_t postado_us; // Quando o mais antigo dos pendentes foi postado
+    struct async_context *contexto;
+    struct async_when_pending_worker *worker;
+} EventosAssinante;
+
+typedef struct
+{
+    uint32_t amostras;
+    uint32_t media_us; // Do evento até o consumidor terminar
+    uint32_t max_us;
+} EventosLatencia;
+
+void init_eventos(void);
+
+// O 'worker' é marcado pendente no 'contexto' a cada evento da máscara; sem
+// worker, o assinante consulta eventos_retirar() e é acordado com __sev()
+bool eventos_assinar(EventosAssinante *a, uint32_t eventos, struct async_context *contexto,
+                     struct async_when_pending_worker *worker);
+
+// De qualquer contexto: interrupção, worker ou o outro núcleo
+void eventos_postar(uint32_t eventos);
+
+// Devolve e limpa os eventos pendentes do assinante
+uint32_t eventos_retirar(EventosAssinante *a, uint64_t *postado_us);
+
+// Latência do evento até a saída (ex.: o quadro entregue à matriz)
+void eventos_registrar_latencia(uint64_t postado_us);
+void eventos_latencia(EventosLatencia *l); // Desde a chamada anterior
+
+#endif
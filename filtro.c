@@ -0,0 +1,153 @@
+#include "filtro.h"
+#include <math.h>
+#include <string.h>
+
+void filtro_init(Filtro *f)
+{
+    memset(f, 0, sizeof(*f));
+    f->dec_fator = 1;
+}
+
+void filtro_config_mediana(Filtro *f, uint8_t n)
+{
+    if (n > FILTRO_MEDIANA_MAX)
+    {
+        n = FILTRO_MEDIANA_MAX;
+    }
+    f->mediana_n = (n > 1) ? (n | 1) : 0; // Só janelas ímpares têm mediana exata
+    if (f->mediana_n > FILTRO_MEDIANA_MAX)
+    {
+        f->mediana_n = FILTRO_MEDIANA_MAX;
+    }
+    f->mediana_pos = 0;
+    f->mediana_cont = 0;
+}
+
+// Coeficientes calculados uma única vez; o processamento por amostra é só inteiro.
+// raio (0 < r < 1) controla a largura do entalhe: mais perto de 1, mais estreito.
+void filtro_config_notch(Filtro *f, uint32_t freq_hz, uint32_t amostragem_hz, float raio)
+{
+    if (freq_hz == 0 || amostragem_hz <= 2 * freq_hz)
+    {
+        f->notch_ativo = false; // Frequência acima de Nyquist: não há o que filtrar
+        return;
+    }
+    float c = cosf(2.0f * (float)M_PI * (float)freq_hz / (float)amostragem_hz);
+    float a1 = -2.0f * raio * c;
+    float a2 = raio * raio;
+    // Normaliza o ganho em DC para 1: o nível médio de luz não muda
+    float g = (1.0f + a1 + a2) / (2.0f - 2.0f * c);
+    const float escala = (float)(1 << FILTRO_COEF_FRAC);
+
+    f->b0 = lroundf(g * escala);
+    f->b1 = lroundf(-2.0f * c * g * escala);
+    f->b2 = f->b0;
+    f->a1 = lroundf(a1 * escala);
+    f->a2 = lroundf(a2 * escala);
+    f->notch_ativo = true;
+    f->notch_iniciado = false;
+}
+
+void filtro_config_sobreamostragem(Filtro *f, uint8_t bits_extra)
+{
+    if (bits_extra > 4)
+    {
+        bits_extra = 4; // 4^4 = 256 amostras por saída
+    }
+    f->bits_extra = bits_extra;
+    f->dec_fator = 1u << (2 * bits_extra);
+    f->dec_cont = 0;
+    f->dec_soma = 0;
+}
+
+void filtro_config_passa_baixa(Filtro *f, uint8_t k)
+{
+    f->iir_k = (k > 15) ? 15 : k;
+    f->iir_iniciado = false;
+}
+
+static int32_t mediana(Filtro *f, int32_t x)
+{
+    f->mediana_buf[f->mediana_pos] = x;
+    if (++f->mediana_pos == f->mediana_n)
+    {
+        f->mediana_pos = 0;
+    }
+    if (f->mediana_cont < f->mediana_n)
+    {
+        f->mediana_cont++;
+    }
+
+    // Ordenação por inserção de no máximo FILTRO_MEDIANA_MAX valores
+    int32_t ordenado[FILTRO_MEDIANA_MAX];
+    uint8_t n = f->mediana_cont;
+    for (uint8_t i = 0; i < n; i++)
+    {
+        int32_t v = f->mediana_buf[i];
+        int8_t j = i - 1;
+        while (j >= 0 && ordenado[j] > v)
+        {
+            ordenado[j + 1] = ordenado[j];
+            j--;
+        }
+        ordenado[j + 1] = v;
+    }
+    return ordenado[n / 2];
+}
+
+static int32_t notch(Filtro *f, int32_t x)
+{
+    if (!f->notch_iniciado)
+    {
+        // Parte do regime permanente para não gerar transitório na partida
+        f->x1 = f->x2 = f->y1 = f->y2 = x;
+        f->notch_iniciado = true;
+    }
+    int64_t acc = (int64_t)f->b0 * x + (int64_t)f->b1 * f->x1 + (int64_t)f->b2 * f->x2 - (int64_t)f->a1 * f->y1 - (int64_t)f->a2 * f->y2;
+    int32_t y = (int32_t)((acc + (1 << (FILTRO_COEF_FRAC - 1))) >> FILTRO_COEF_FRAC);
+    f->x2 = f->x1;
+    f->x1 = x;
+    f->y2 = f->y1;
+    f->y1 = y;
+    return y;
+}
+
+bool filtro_amostra(Filtro *f, int32_t x)
+{
+    if (f->mediana_n)
+    {
+        x = mediana(f, x);
+    }
+    if (f->notch_ativo)
+    {
+        x = notch(f, x);
+    }
+
+    if (f->dec_fator > 1)
+    {
+        f->dec_soma += x;
+        if (++f->dec_cont < f->dec_fator)
+        {
+            return false;
+        }
+        // Soma de 4^b amostras dividida por 2^b: b bits a mais de resolução efetiva
+        x = f->dec_soma >> f->bits_extra;
+        f->dec_soma = 0;
+        f->dec_cont = 0;
+    }
+
+    if (f->iir_k)
+    {
+        int32_t alvo = x << FILTRO_IIR_FRAC;
+        if (!f->iir_iniciado)
+        {
+            f->iir_estado = alvo;
+            f->iir_iniciado = true;
+        }
+        f->iir_estado += (alvo - f->iir_estado) >> f->iir_k;
+        x = (f->iir_estado + (1 << (FILTRO_IIR_FRAC - 1))) >> FILTRO_IIR_FRAC;
+    }
+
+    f->saida = x;
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef FILTRO_H
+#define FILTRO_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FILTRO_MEDIANA_MAX 7  // Maior janela da mediana (ímpar)
+#define FILTRO_COEF_FRAC 14   // Coeficientes do notch em Q2.14
+#define FILTRO_IIR_FRAC 8     // Bits fracionários do estado do passa-baixa
+
+// Cadeia de filtros em ponto fixo para amostras do ADC, na ordem:
+// mediana -> notch (rede) -> sobreamostragem/decimação -> passa-baixa IIR.
+// Cada estágio tem custo fixo por amostra e pode ser desligado isoladamente.
+typedef struct
+{
+    // Mediana de N: rejeita picos isolados
+    uint8_t mediana_n;
+    uint8_t mediana_pos;
+    uint8_t mediana_cont;
+    int32_t mediana_buf[FILTRO_MEDIANA_MAX];
+
+    // Notch biquad (forma direta I)
+    bool notch_ativo;
+    bool notch_iniciado;
+    int32_t b0, b1, b2, a1, a2;
+    int32_t x1, x2, y1, y2;
+
+    // Sobreamostragem: soma 4^bits amostras e ganha 'bits' de resolução
+    uint8_t bits_extra;
+    uint16_t dec_fator;
+    uint16_t dec_cont;
+    int32_t dec_soma;
+
+    // Passa-baixa de 1ª ordem: y += (x - y) / 2^k
+    uint8_t iir_k;
+    bool iir_iniciado;
+    int32_t iir_estado;
+
+    int32_t saida; // Na escala da entrada multiplicada por 2^bits_extra
+} Filtro;
+
+void filtro_init(Filtro *f);
+void filtro_config_mediana(Filtro *f, uint8_t n);
+void filtro_config_notch(Filtro *f, uint32_t freq_hz, uint32_t amostragem_hz, float raio);
+void filtro_config_sobreamostragem(Filtro *f, uint8_t bits_extra);
+void filtro_config_passa_baixa(Filtro *f, uint8_t k);
+
+// Processa uma amostra; devolve true quando uma nova saída foi produzida
+bool filtro_amostra(Filtro *f, int32_t x);
+
+static inline int32_t filtro_saida(const Filtro *f)
+{
+    return f->saida;
+}
+
+#endif
@@ -0,0 +1,257 @@
+#include "formato.h"
+#include <string.h>
+
+// Escreve os dígitos de v (ao menos 'largura') de trás para frente em tmp
+static uint escrever_digitos(char *fim, uint64_t v, uint largura)
+{
+    uint n = 0;
+    do
+    {
+        *--fim = (char)('0' + v % 10);
+        v /= 10;
+        n++;
+    } while (v || n < largura);
+    return n;
+}
+
+static size_t copiar(char *buf, size_t tam, const char *src, size_t n)
+{
+    if (tam == 0)
+    {
+        return 0;
+    }
+    if (n >= tam)
+    {
+        buf[0] = '\0';
+        return 0;
+    }
+    memcpy(buf, src, n);
+    buf[n] = '\0';
+    return n;
+}
+
+static size_t escrever_centesimos(char *buf, size_t tam, bool negativo, uint64_t c)
+{
+    char tmp[24];
+    char *fim = tmp + sizeof(tmp);
+    uint n = escrever_digitos(fim, c, 3); // "0.05" precisa de ao menos 3 dígitos
+    // Abre espaço para o ponto antes dos dois últimos dígitos
+    char *ini = fim - n;
+    memmove(ini - 1, ini, n - 2);
+    ini--;
+    fim[-3] = '.';
+    n++;
+    if (negativo)
+    {
+        *--ini = '-';
+        n++;
+    }
+    return copiar(buf, tam, ini, n);
+}
+
+size_t formato_centesimos(char *buf, size_t tam, int32_t centesimos)
+{
+    bool negativo = centesimos < 0;
+    uint64_t c = negativo ? (uint64_t)(-(int64_t)centesimos) : (uint64_t)centesimos;
+    return escrever_centesimos(buf, tam, negativo, c);
+}
+
+// round(|v| * 100) exato: v = m * 2^e, então v * 100 = (m * 100) * 2^e, com
+// m * 100 < 2^31. Só inteiros, sem a imprecisão de multiplicar em float.
+static uint64_t centesimos_exatos(uint32_t bits)
+{
+    int32_t exp = (int32_t)((bits >> 23) & 0xFF);
+    uint64_t m = bits & 0x7FFFFF;
+    if (exp == 0)
+    {
+        exp = 1; // Subnormal
+    }
+    else
+    {
+        m |= 0x800000;
+    }
+    int32_t e = exp - 127 - 23;
+    uint64_t n = m * 100;
+
+    if (e >= 0)
+    {
+        return (e > 32) ? UINT64_MAX : n << e; // n < 2^31: cabe em 64 bits até e = 32
+    }
+    if (e < -40)
+    {
+        return 0; // n < 2^31, então o valor é menor que 2^-9 centésimos
+    }
+    uint s = (uint)-e;
+    uint64_t q = n >> s;
+    uint64_t r = n & (((uint64_t)1 << s) - 1);
+    uint64_t metade = (uint64_t)1 << (s - 1);
+    if (r > metade || (r == metade && (q & 1)))
+    {
+        q++; // Empate vai para o par, como o printf
+    }
+    return q;
+}
+
+size_t formato_decimal2(char *buf, size_t tam, float valor)
+{
+    uint32_t bits;
+    memcpy(&bits, &valor, sizeof(bits));
+    bool negativo = bits >> 31; // printf escreve "-0.00" para negativos que arredondam a zero
+
+    if (((bits >> 23) & 0xFF) == 0xFF)
+    {
+        const char *s = (bits & 0x7FFFFF) ? "nan" : negativo ? "-inf"
+                                                              : "inf";
+        return copiar(buf, tam, s, strlen(s));
+    }
+    return escrever_centesimos(buf, tam, negativo, centesimos_exatos(bits));
+}
+
+size_t formato_inteiro(char *buf, size_t tam, uint32_t valor, uint largura)
+{
+    char tmp[12];
+    char *fim = tmp + sizeof(tmp);
+    uint n = escrever_digitos(fim, valor, largura > 10 ? 10 : largura);
+    return copiar(buf, tam, fim - n, n);
+}
+
+bool formato_ler_centesimos(const char *texto, int32_t *centesimos)
+{
+    const char *p = texto;
+    while (*p == ' ' || *p == '\t')
+    {
+        p++;
+    }
+    bool negativo = *p == '-';
+    if (*p == '-' || *p == '+')
+    {
+        p++;
+    }
+
+    int64_t valor = 0;
+    bool digitos = false;
+    while (*p >= '0' && *p <= '9')
+    {
+        if (valor < 100000000)
+        {
+            valor = valor * 10 + (*p - '0');
+        }
+        digitos = true;
+        p++;
+    }
+    valor *= 100;
+    if (*p == '.')
+    {
+        p++;
+        for (int casa = 0; *p >= '0' && *p <= '9'; casa++, p++)
+        {
+            digitos = true;
+            if (casa == 0)
+            {
+                valor += (*p - '0') * 10;
+            }
+            else if (casa == 1)
+            {
+                valor += *p - '0';
+            }
+            else if (casa == 2 && *p >= '5')
+            {
+                valor++;
+            }
+        }
+    }
+    if (!digitos || valor > INT32_MAX)
+    {
+        return false; // A partir de 21474836.48 não cabe em int32_t
+    }
+    *centesimos = (int32_t)(negativo ? -valor : valor);
+    return true;
+}
+
+static void json_escrever(Json *j, const char *s, size_t n)
+{
+    if (j->estouro || j->pos + n >= j->tam)
+    {
+        j->estouro = true;
+        return;
+    }
+    memcpy(j->buf + j->pos, s, n);
+    j->pos += n;
+}
+
+static void json_chave(Json *j, const char *chave)
+{
+    if (!j->primeiro)
+    {
+        json_escrever(j, ",", 1);
+    }
+    j->primeiro = false;
+    json_escrever(j, "\"", 1);
+    json_escrever(j, chave, strlen(chave));
+    json_escrever(j, "\":", 2);
+}
+
+void json_abrir(Json *j, char *buf, size_t tam)
+{
+    j->buf = buf;
+    j->tam = tam;
+    j->pos = 0;
+    j->primeiro = true;
+    j->estouro = tam == 0;
+    json_escrever(j, "{", 1);
+}
+
+void json_decimal2(Json *j, const char *chave, float valor)
+{
+    char tmp[24];
+    json_chave(j, chave);
+    json_escrever(j, tmp, formato_decimal2(tmp, sizeof(tmp), valor));
+}
+
+void json_centesimos(Json *j, const char *chave, int32_t centesimos)
+{
+    char tmp[16];
+    json_chave(j, chave);
+    json_escrever(j, tmp, formato_centesimos(tmp, sizeof(tmp), centesimos));
+}
+
+void json_inteiro(Json *j, const char *chave, int32_t valor)
+{
+    json_chave(j, chave);
+    if (valor < 0)
+    {
+        json_escrever(j, "-", 1);
+    }
+    char tmp[12];
+    json_escrever(j, tmp, formato_inteiro(tmp, sizeof(tmp), valor < 0 ? -(uint32_t)valor : (uint32_t)valor, 0));
+}
+
+void json_texto(Json *j, const char *chave, const char *valor)
+{
+    json_chave(j, chave);
+    json_escrever(j, "\"", 1);
+    for (const char *p = valor; *p; p++)
+    {
+        if (*p == '"' || *p == '\\')
+        {
+            json_escrever(j, "\\", 1);
+        }
+        json_escrever(j, p, 1);
+    }
+    json_escrever(j, "\"", 1);
+}
+
+size_t json_fechar(Json *j)
+{
+    json_escrever(j, "}", 1);
+    if (j->estouro)
+    {
+        if (j->tam)
+        {
+            j->buf[0] = '\0';
+        }
+        return 0;
+    }
+    j->buf[j->pos] = '\0';
+    return j->pos;
+}
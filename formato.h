@@ -0,0 +1,42 @@
+#ifndef FORMATO_H
+#define FORMATO_H
+
+#include "pico/stdlib.h"
+
+// Formatação de números e JSON sem printf, escrevendo em buffers do chamador.
+// As funções devolvem o tamanho escrito (sem o '\0') ou 0 se o buffer não
+// comporta o texto; o buffer sempre termina em '\0' quando tam > 0.
+
+// Igual a "%.2f": arredonda o valor binário exato para o par mais próximo,
+// como o printf. Exato para |valor| < 2^56; acima disso satura.
+size_t formato_decimal2(char *buf, size_t tam, float valor);
+
+// Valor em centésimos (ex.: 6550 -> "65.50")
+size_t formato_centesimos(char *buf, size_t tam, int32_t centesimos);
+
+// Lê "[-]123.456" como centésimos, arredondando a 3ª casa (ex.: "65.5" -> 6550).
+// Ignora espaços iniciais e para no primeiro caractere inválido; false se não há
+// dígitos ou se o valor em centésimos não cabe em int32_t.
+bool formato_ler_centesimos(const char *texto, int32_t *centesimos);
+
+// Igual a "%0*u" com largura mínima 'largura' (0 = sem zeros à esquerda)
+size_t formato_inteiro(char *buf, size_t tam, uint32_t valor, uint largura);
+
+// Construtor de objeto JSON em fluxo: {"a":1.00,"b":"x"}
+typedef struct
+{
+    char *buf;
+    size_t tam;
+    size_t pos;
+    bool primeiro;
+    bool estouro;
+} Json;
+
+void json_abrir(Json *j, char *buf, size_t tam);
+void json_decimal2(Json *j, const char *chave, float valor);
+void json_centesimos(Json *j, const char *chave, int32_t centesimos);
+void json_inteiro(Json *j, const char *chave, int32_t valor);
+void json_texto(Json *j, const char *chave, const char *valor);
+size_t json_fechar(Json *j); // Tamanho final, ou 0 se estourou o buffer
+
+#endif
@@ -0,0 +1,30 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include "pico/stdlib.h"
+#include "eventos.h"
+#include "saida.h"
+
+// Camada fina entre a lógica dos cômodos (aplicacao.c) e o hardware. No Pico
+// as funções de atuador ficam em hal_pico.c e as de MQTT em main.c, que é dono
+// do cliente lwIP; no PC, tools/host/hal_host.c troca tudo por simulações.
+
+// Atuadores
+void init_hal(void);
+void hal_set_janela(uint16_t pos); // Centésimos de porcento
+void hal_set_luz(bool on);
+void hal_set_led(bool on);         // LED da placa (/led)
+
+// Avisa quem mostra o estado (matriz, painel) de que algo mudou: EVENTO_*
+void hal_notificar(uint32_t eventos);
+
+// Milissegundos desde o boot
+uint32_t hal_agora_ms(void);
+
+// Transporte MQTT: devolve false se a mensagem não pôde ser enfileirada. A
+// prioridade (SAIDA_*) decide a ordem de saída e quem é descartado primeiro.
+bool hal_mqtt_publicar(const char *topico, const void *payload, uint16_t len, bool retain, SaidaPrioridade prioridade);
+const char *hal_mqtt_topico(const char *nome); // Prefixa o id do dispositivo, se configurado
+void hal_mqtt_encerrar(void);                  // Cancela as assinaturas e desconecta
+
+#endif
@@ -0,0 +1,76 @@
+#include "hal.h"
+#include "nucleos.h"
+#include "pico/cyw43_arch.h"
+#include "hardware/gpio.h"
+#include "hardware/pwm.h"
+
+// PAINEL_OLED vem do CMakeLists.txt (opção desligada por padrão)
+#if PAINEL_OLED
+// GPIO14/15 são o I2C do OLED na BitDogLab: servo e relé vão para o conector de expansão
+#define SERVO_PIN 8           // Servo para janela
+#define LIGHT_PIN 9           // Relé/LED para luz
+#else
+#define SERVO_PIN 15          // Servo para janela
+#define LIGHT_PIN 14          // Relé/LED para luz
+#endif
+
+#define LED_BLUE_PIN 12  // GPIO12 - LED azul
+#define LED_GREEN_PIN 11 // GPIO11 - LED verde
+#define LED_RED_PIN 13   // GPIO13 - LED vermelho
+
+static void init_servo(void)
+{
+    gpio_set_function(SERVO_PIN, GPIO_FUNC_PWM);
+    uint slice_num = pwm_gpio_to_slice_num(SERVO_PIN);
+    pwm_config config = pwm_get_default_config();
+    pwm_config_set_clkdiv(&config, 125.0f); // 1MHz
+    pwm_config_set_wrap(&config, 20000);    // 20ms
+    pwm_init(slice_num, &config, true);
+    hal_set_janela(0); // Inicia fechada
+}
+
+void init_hal(void)
+{
+    init_servo();
+    gpio_init(LIGHT_PIN);
+    gpio_set_dir(LIGHT_PIN, GPIO_OUT);
+    gpio_init(LED_RED_PIN);
+    gpio_set_dir(LED_RED_PIN, GPIO_OUT);
+    gpio_init(LED_GREEN_PIN);
+    gpio_set_dir(LED_GREEN_PIN, GPIO_OUT);
+    gpio_init(LED_BLUE_PIN);
+    gpio_set_dir(LED_BLUE_PIN, GPIO_OUT);
+    hal_set_luz(false);
+}
+
+void hal_set_janela(uint16_t pos)
+{
+    uint16_t pulse = 500 + pos / 5; // 500us (0°) to 2500us (180°): 2000us / 10000
+    pwm_set_gpio_level(SERVO_PIN, pulse);
+}
+
+void hal_set_luz(bool on)
+{
+    gpio_put(LIGHT_PIN, on ? 1 : 0);
+    gpio_put(LED_RED_PIN, on ? 1 : 0);
+    gpio_put(LED_GREEN_PIN, on ? 1 : 0);
+    gpio_put(LED_BLUE_PIN, on ? 1 : 0);
+}
+
+// Com NUCLEOS_DUPLO a aplicação roda no núcleo 1 e o LED vai pelo anel de nucleos.c
+#if !NUCLEOS_DUPLO
+void hal_set_led(bool on)
+{
+    cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, on ? 1 : 0);
+}
+#endif
+
+void hal_notificar(uint32_t eventos)
+{
+    eventos_postar(eventos);
+}
+
+uint32_t hal_agora_ms(void)
+{
+    return to_ms_since_boot(get_absolute_time());
+}
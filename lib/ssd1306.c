@@ -1,47 +1,134 @@
 #include "ssd1306.h"
 #include "font.h"
 
+// Posição do byte da coluna x na página informada (modo de endereçamento vertical)
+static inline uint16_t ssd1306_index(ssd1306_t *ssd, uint8_t x, uint8_t page) {
+  return 1 + x * ssd->pages + page;
+}
+
+static inline void ssd1306_clear_dirty(ssd1306_t *ssd) {
+  memset(ssd->dirty_x0, 0xFF, sizeof(ssd->dirty_x0));
+  memset(ssd->dirty_x1, 0x00, sizeof(ssd->dirty_x1));
+}
+
+// Marca colunas alteradas de uma página; no modo texto, esquece as células tocadas
+static inline void ssd1306_mark_dirty_page(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page) {
+  if (ssd->text_grid)
+    memset(&ssd->text_cells[page][x0 >> 3], 0, (x1 >> 3) - (x0 >> 3) + 1);
+  if (x0 < ssd->dirty_x0[page])
+    ssd->dirty_x0[page] = x0;
+  if (x1 > ssd->dirty_x1[page])
+    ssd->dirty_x1[page] = x1;
+}
+
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
   ssd->width = width;
   ssd->height = height;
   ssd->pages = height / 8U;
   ssd->address = address;
   ssd->i2c_port = i2c;
+  ssd->external_vcc = external_vcc;
   ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  // Desloca o buffer 3 bytes para que os pixels (após o byte 0x40) fiquem
+  // alinhados em 4 bytes e o blitter possa usar escritas de 32 bits
+  ssd->ram_buffer = (uint8_t *)calloc(ssd->bufsize + 3, sizeof(uint8_t)) + 3;
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->tx_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->tx_buffer[0] = 0x40;
+  ssd->bytes_sent = 0;
+  ssd->bytes_total = 0;
+  ssd->dma_channel = -1; // Transporte assíncrono só após ssd1306_init_dma()
+  ssd->dma_buffer = NULL;
+  ssd->busy = false;
+  ssd->text_grid = false;
+  ssd1306_invalidate(ssd); // A RAM do display começa com lixo: o primeiro envio é completo
+}
+
+// ---------------------------------------------------------------------------
+// Perfis de inicialização: cada tabela vai numa única transação I2C no formato
+// de fluxo de comandos (byte de controle 0x00 seguido dos comandos).
+// ---------------------------------------------------------------------------
+
+static const uint8_t ssd1306_init_128x64[] = {
+  SET_DISP | 0x00,
+  SET_MEM_ADDR, 0x01,          // endereçamento vertical
+  SET_DISP_START_LINE | 0x00,
+  SET_SEG_REMAP | 0x01,
+  SET_MUX_RATIO, 64 - 1,
+  SET_COM_OUT_DIR | 0x08,
+  SET_DISP_OFFSET, 0x00,
+  SET_COM_PIN_CFG, 0x12,
+  SET_DISP_CLK_DIV, 0x80,
+  SET_PRECHARGE, 0xF1,
+  SET_VCOM_DESEL, 0x30,
+  SET_CONTRAST, 0xFF,
+  SET_ENTIRE_ON,
+  SET_NORM_INV,
+  SET_CHARGE_PUMP, 0x14,       // charge pump interno
+  SET_DISP | 0x01,
+};
+
+static const uint8_t ssd1306_init_128x64_ext_vcc[] = {
+  SET_DISP | 0x00,
+  SET_MEM_ADDR, 0x01,
+  SET_DISP_START_LINE | 0x00,
+  SET_SEG_REMAP | 0x01,
+  SET_MUX_RATIO, 64 - 1,
+  SET_COM_OUT_DIR | 0x08,
+  SET_DISP_OFFSET, 0x00,
+  SET_COM_PIN_CFG, 0x12,
+  SET_DISP_CLK_DIV, 0x80,
+  SET_PRECHARGE, 0x22,
+  SET_VCOM_DESEL, 0x30,
+  SET_CONTRAST, 0x9F,
+  SET_ENTIRE_ON,
+  SET_NORM_INV,
+  SET_CHARGE_PUMP, 0x10,       // VCC externo: charge pump desligado
+  SET_DISP | 0x01,
+};
+
+static const uint8_t ssd1306_init_128x32[] = {
+  SET_DISP | 0x00,
+  SET_MEM_ADDR, 0x01,
+  SET_DISP_START_LINE | 0x00,
+  SET_SEG_REMAP | 0x01,
+  SET_MUX_RATIO, 32 - 1,
+  SET_COM_OUT_DIR | 0x08,
+  SET_DISP_OFFSET, 0x00,
+  SET_COM_PIN_CFG, 0x02,       // COM sequencial nos painéis de 32 linhas
+  SET_DISP_CLK_DIV, 0x80,
+  SET_PRECHARGE, 0xF1,
+  SET_VCOM_DESEL, 0x30,
+  SET_CONTRAST, 0x8F,
+  SET_ENTIRE_ON,
+  SET_NORM_INV,
+  SET_CHARGE_PUMP, 0x14,
+  SET_DISP | 0x01,
+};
+
+const ssd1306_profile_t ssd1306_profile_128x64 = {ssd1306_init_128x64, sizeof(ssd1306_init_128x64)};
+const ssd1306_profile_t ssd1306_profile_128x64_ext_vcc = {ssd1306_init_128x64_ext_vcc, sizeof(ssd1306_init_128x64_ext_vcc)};
+const ssd1306_profile_t ssd1306_profile_128x32 = {ssd1306_init_128x32, sizeof(ssd1306_init_128x32)};
+
+// Janela de endereçamento; as posições 1, 2, 4 e 5 são preenchidas a cada envio
+static const uint8_t ssd1306_addr_preamble[] = {SET_COL_ADDR, 0, WIDTH - 1, SET_PAGE_ADDR, 0, (HEIGHT / 8) - 1};
+
+void ssd1306_config_profile(ssd1306_t *ssd, const ssd1306_profile_t *profile) {
+  ssd1306_command_list(ssd, profile->cmds, profile->len);
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
+  if (ssd->height <= 32)
+    ssd1306_config_profile(ssd, &ssd1306_profile_128x32);
+  else if (ssd->external_vcc)
+    ssd1306_config_profile(ssd, &ssd1306_profile_128x64_ext_vcc);
+  else
+    ssd1306_config_profile(ssd, &ssd1306_profile_128x64);
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
+  ssd1306_wait(ssd);
   ssd->port_buffer[1] = command;
   i2c_write_blocking(
     ssd->i2c_port,
@@ -52,66 +139,354 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   );
 }
 
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t len) {
+  uint8_t buffer[1 + SSD1306_CMD_LIST_MAX];
+  ssd1306_wait(ssd);
+  buffer[0] = 0x00; // Co = 0, D/C = 0: todos os bytes seguintes são comandos
+  while (len) {
+    size_t n = len < SSD1306_CMD_LIST_MAX ? len : SSD1306_CMD_LIST_MAX;
+    memcpy(&buffer[1], commands, n);
+    i2c_write_blocking(
+      ssd->i2c_port,
+      ssd->address,
+      buffer,
+      n + 1,
+      false
+    );
+    commands += n;
+    len -= n;
+  }
+}
+
+// Preenche a janela de endereçamento a partir da tabela constante
+static inline void ssd1306_fill_preamble(uint8_t *preamble, uint8_t c0, uint8_t c1, uint8_t p0, uint8_t p1) {
+  memcpy(preamble, ssd1306_addr_preamble, sizeof(ssd1306_addr_preamble));
+  preamble[1] = c0;
+  preamble[2] = c1;
+  preamble[4] = p0;
+  preamble[5] = p1;
+}
+
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1) {
+  for (uint8_t p = page0; p <= page1 && p < ssd->pages; ++p)
+    ssd1306_mark_dirty_page(ssd, x0, x1, p);
+}
+
+// Força o reenvio da tela inteira (o conteúdo do buffer não muda)
+void ssd1306_invalidate(ssd1306_t *ssd) {
+  memset(ssd->dirty_x0, 0, sizeof(ssd->dirty_x0));
+  memset(ssd->dirty_x1, ssd->width - 1, sizeof(ssd->dirty_x1));
+}
+
+// Procura a próxima janela suja a partir da página *p, agrupando páginas vizinhas
+static bool ssd1306_next_window(ssd1306_t *ssd, uint8_t *p, uint8_t *c0, uint8_t *c1, uint8_t *p0, uint8_t *p1) {
+  while (*p < ssd->pages && ssd->dirty_x0[*p] > ssd->dirty_x1[*p])
+    ++*p;
+  if (*p >= ssd->pages)
+    return false;
+
+  *p0 = *p;
+  *c0 = ssd->dirty_x0[*p];
+  *c1 = ssd->dirty_x1[*p];
+  while (++*p < ssd->pages && ssd->dirty_x0[*p] <= ssd->dirty_x1[*p]) {
+    if (ssd->dirty_x0[*p] < *c0)
+      *c0 = ssd->dirty_x0[*p];
+    if (ssd->dirty_x1[*p] > *c1)
+      *c1 = ssd->dirty_x1[*p];
+  }
+  *p1 = *p - 1;
+  return true;
+}
+
+// Monta os dados da janela (com o byte de controle 0x40); no modo vertical seguem coluna a coluna
+static size_t ssd1306_gather(ssd1306_t *ssd, uint8_t c0, uint8_t c1, uint8_t p0, uint8_t p1, const uint8_t **data) {
+  if (c0 == 0 && c1 == ssd->width - 1 && p0 == 0 && p1 == ssd->pages - 1) {
+    *data = ssd->ram_buffer; // Tela inteira: usa o buffer direto, sem cópia
+    return ssd->bufsize;
+  }
+
+  uint8_t npages = p1 - p0 + 1;
+  size_t len = 1;
+  if (npages == ssd->pages) {
+    // Colunas completas são contíguas no buffer
+    len += (c1 - c0 + 1) * npages;
+    memcpy(&ssd->tx_buffer[1], &ssd->ram_buffer[ssd1306_index(ssd, c0, 0)], len - 1);
+  } else {
+    for (uint16_t x = c0; x <= c1; ++x) {
+      memcpy(&ssd->tx_buffer[len], &ssd->ram_buffer[ssd1306_index(ssd, x, p0)], npages);
+      len += npages;
+    }
+  }
+  *data = ssd->tx_buffer;
+  return len;
+}
+
+// Envia apenas as páginas sujas, agrupando páginas vizinhas numa mesma janela
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  ssd1306_wait(ssd);
+  ssd->bytes_sent = 0;
+  uint8_t p = 0, c0, c1, p0, p1;
+  while (ssd1306_next_window(ssd, &p, &c0, &c1, &p0, &p1)) {
+    uint8_t preamble[sizeof(ssd1306_addr_preamble)];
+    ssd1306_fill_preamble(preamble, c0, c1, p0, p1);
+    ssd1306_command_list(ssd, preamble, sizeof(preamble));
+
+    const uint8_t *data;
+    size_t len = ssd1306_gather(ssd, c0, c1, p0, p1, &data);
+    i2c_write_blocking(
+      ssd->i2c_port,
+      ssd->address,
+      data,
+      len,
+      false
+    );
+    ssd->bytes_sent += 1 + sizeof(preamble) + len;
+  }
+  ssd1306_clear_dirty(ssd);
+  ssd->bytes_total += ssd->bytes_sent;
+}
+
+// ---------------------------------------------------------------------------
+// Transporte assíncrono: cada janela vira uma sequência de palavras para o
+// registrador IC_DATA_CMD (byte + bits de RESTART/STOP), entregue ao I2C por
+// DMA. O fim da transmissão é detectado pela interrupção STOP_DET.
+// ---------------------------------------------------------------------------
+
+static ssd1306_t *ssd1306_async_owner[2];
+
+static void ssd1306_i2c_irq(uint index) {
+  ssd1306_t *ssd = ssd1306_async_owner[index];
+  if (!ssd)
+    return;
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  if (!(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS))
+    return;
+  (void)hw->clr_stop_det;
+  hw->intr_mask = 0;
+
+  if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+    // NACK ou perda de arbitragem: descarta o restante e reenvia a tela no próximo flush
+    dma_channel_abort(ssd->dma_channel);
+    (void)hw->clr_tx_abrt;
+    ssd1306_invalidate(ssd);
+  } else {
+    ssd->bytes_total += ssd->bytes_sent;
+  }
+
+  ssd->busy = false;
+  if (ssd->done_cb)
+    ssd->done_cb(ssd, ssd->done_arg);
+}
+
+static void ssd1306_i2c0_irq(void) {
+  ssd1306_i2c_irq(0);
+}
+
+static void ssd1306_i2c1_irq(void) {
+  ssd1306_i2c_irq(1);
+}
+
+bool ssd1306_init_dma(ssd1306_t *ssd) {
+  uint index = i2c_hw_index(ssd->i2c_port);
+  if (ssd1306_async_owner[index])
+    return false;
+
+  int channel = dma_claim_unused_channel(false);
+  if (channel < 0)
+    return false;
+  // Pior caso: uma janela por página, cada uma com o preâmbulo de endereçamento
+  ssd->dma_buffer = calloc(ssd->bufsize + SSD1306_MAX_PAGES * (2 + sizeof(ssd1306_addr_preamble)), sizeof(uint16_t));
+  if (!ssd->dma_buffer) {
+    dma_channel_unclaim(channel);
+    return false;
+  }
+  ssd->dma_channel = channel;
+  ssd->busy = false;
+  ssd1306_async_owner[index] = ssd;
+
+  uint irq = index ? I2C1_IRQ : I2C0_IRQ;
+  irq_set_exclusive_handler(irq, index ? ssd1306_i2c1_irq : ssd1306_i2c0_irq);
+  irq_set_enabled(irq, true);
+  return true;
+}
+
+bool ssd1306_send_data_async(ssd1306_t *ssd, ssd1306_callback_t cb, void *arg) {
+  if (ssd->dma_channel < 0 || ssd->busy)
+    return false;
+
+  // Copia as janelas sujas para o buffer do DMA: o desenho pode continuar durante o envio
+  uint16_t *out = ssd->dma_buffer;
+  uint8_t p = 0, c0, c1, p0, p1;
+  while (ssd1306_next_window(ssd, &p, &c0, &c1, &p0, &p1)) {
+    uint8_t preamble[sizeof(ssd1306_addr_preamble)];
+    ssd1306_fill_preamble(preamble, c0, c1, p0, p1);
+    // Cada janela começa uma nova transação, em fluxo de comandos (0x00)
+    uint16_t restart = (out != ssd->dma_buffer) ? I2C_IC_DATA_CMD_RESTART_BITS : 0;
+    *out++ = restart | 0x00;
+    for (uint i = 0; i < sizeof(preamble); ++i)
+      *out++ = preamble[i];
+
+    const uint8_t *data;
+    size_t len = ssd1306_gather(ssd, c0, c1, p0, p1, &data);
+    *out++ = I2C_IC_DATA_CMD_RESTART_BITS | data[0]; // troca para o fluxo de dados (0x40)
+    for (size_t i = 1; i < len; ++i)
+      *out++ = data[i];
+  }
+  ssd1306_clear_dirty(ssd);
+
+  uint count = out - ssd->dma_buffer;
+  ssd->bytes_sent = count;
+  if (count == 0) {
+    if (cb)
+      cb(ssd, arg);
+    return true;
+  }
+  ssd->dma_buffer[count - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+  ssd->done_cb = cb;
+  ssd->done_arg = arg;
+  ssd->busy = true;
+
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  hw->enable = 0;
+  hw->tar = ssd->address;
+  hw->enable = 1;
+  (void)hw->clr_stop_det;
+  (void)hw->clr_tx_abrt;
+  hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS;
+
+  dma_channel_config c = dma_channel_get_default_config(ssd->dma_channel);
+  channel_config_set_transfer_data_size(&c, DMA_SIZE_16);
+  channel_config_set_read_increment(&c, true);
+  channel_config_set_write_increment(&c, false);
+  channel_config_set_dreq(&c, i2c_get_dreq(ssd->i2c_port, true));
+  dma_channel_configure(ssd->dma_channel, &c, &hw->data_cmd, ssd->dma_buffer, count, true);
+  return true;
+}
+
+bool ssd1306_busy(ssd1306_t *ssd) {
+  return ssd->busy;
+}
+
+void ssd1306_wait(ssd1306_t *ssd) {
+  while (ssd->busy)
+    tight_loop_contents();
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint16_t index = ssd1306_index(ssd, x, y >> 3);
   uint8_t pixel = (y & 0b111);
+  ssd1306_mark_dirty_page(ssd, x, x, y >> 3);
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
   else
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// ---------------------------------------------------------------------------
+// Blitter: opera direto no layout de páginas (1 byte = 8 pixels verticais de
+// uma coluna). Bytes inteiros são preenchidos de uma vez, as bordas parciais
+// usam máscara e trechos alinhados são escritos em palavras de 32 bits.
+// ---------------------------------------------------------------------------
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+static inline void ssd1306_apply_mask(uint8_t *dst, uint8_t mask, bool value) {
+  if (value)
+    *dst |= mask;
+  else
+    *dst &= ~mask;
 }
 
+// Preenche n bytes com o mesmo valor usando palavras de 32 bits quando alinhado
+static void ssd1306_fill_bytes(uint8_t *dst, size_t n, uint8_t byte) {
+  while (n && ((uintptr_t)dst & 3)) {
+    *dst++ = byte;
+    --n;
+  }
+  uint32_t word = byte * 0x01010101u;
+  uint32_t *dst32 = (uint32_t *)dst;
+  for (; n >= 4; n -= 4)
+    *dst32++ = word;
+  dst = (uint8_t *)dst32;
+  while (n--)
+    *dst++ = byte;
+}
 
+// Preenche as linhas y0..y1 (já recortadas) das colunas x0..x1
+static void ssd1306_fill_area(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y0, uint8_t y1, bool value) {
+  uint8_t page0 = y0 >> 3;
+  uint8_t page1 = y1 >> 3;
+  uint8_t mask0 = 0xFF << (y0 & 7);
+  uint8_t mask1 = 0xFF >> (7 - (y1 & 7));
+  uint8_t head = 0, tail = 0;        // máscaras das páginas parciais (0 = nenhuma)
+  uint8_t full0 = page0, full1 = page1 + 1; // páginas inteiras: [full0, full1)
 
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
+  if (page0 == page1) {
+    mask0 &= mask1;
+    if (mask0 != 0xFF) {
+      head = mask0;
+      full1 = full0;
+    }
+  } else {
+    if (mask0 != 0xFF) {
+      head = mask0;
+      ++full0;
+    }
+    if (mask1 != 0xFF) {
+      tail = mask1;
+      --full1;
+    }
   }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
+
+  uint8_t byte = value ? 0xFF : 0x00;
+  uint8_t *col = &ssd->ram_buffer[ssd1306_index(ssd, x0, 0)];
+  if (!head && !tail && full0 == 0 && full1 == ssd->pages) {
+    // Colunas completas são contíguas: um único preenchimento cobre a área
+    ssd1306_fill_bytes(col, (size_t)(x1 - x0 + 1) * ssd->pages, byte);
+  } else {
+    for (uint16_t x = x0; x <= x1; ++x, col += ssd->pages) {
+      if (head)
+        ssd1306_apply_mask(&col[page0], head, value);
+      if (full1 > full0)
+        ssd1306_fill_bytes(&col[full0], full1 - full0, byte);
+      if (tail)
+        ssd1306_apply_mask(&col[page1], tail, value);
+    }
   }
+  ssd1306_mark_dirty(ssd, x0, x1, page0, page1);
+}
+
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  memset(&ssd->ram_buffer[1], value ? 0xFF : 0x00, ssd->bufsize - 1);
+  ssd1306_mark_dirty(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+  // Tela apagada equivale a células com espaço (glifo todo zerado)
+  if (ssd->text_grid && !value)
+    memset(ssd->text_cells, ' ', sizeof(ssd->text_cells));
+}
+
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  if (width == 0 || height == 0 || left >= ssd->width || top >= ssd->height)
+    return;
+  uint16_t right = left + width - 1;
+  uint16_t bottom = top + height - 1;
 
   if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
+    ssd1306_fill_area(ssd, left,
+                      right < ssd->width ? right : ssd->width - 1,
+                      top,
+                      bottom < ssd->height ? bottom : ssd->height - 1,
+                      value);
+    return;
   }
+
+  // Contorno: as bordas que caem fora da tela são simplesmente omitidas
+  ssd1306_hline(ssd, left, right < ssd->width ? right : ssd->width - 1, top, value);
+  if (bottom < ssd->height)
+    ssd1306_hline(ssd, left, right < ssd->width ? right : ssd->width - 1, bottom, value);
+  ssd1306_vline(ssd, left, top, bottom < ssd->height ? bottom : ssd->height - 1, value);
+  if (right < ssd->width)
+    ssd1306_vline(ssd, right, top, bottom < ssd->height ? bottom : ssd->height - 1, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
@@ -144,48 +519,114 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  if (x0 > x1) {
+    uint8_t t = x0;
+    x0 = x1;
+    x1 = t;
+  }
+  if (y >= ssd->height || x0 >= ssd->width)
+    return;
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+
+  // Uma linha horizontal toca um bit de cada coluna; colunas vizinhas ficam a
+  // 'pages' bytes (em variável local: o buffer poderia apontar para *ssd)
+  uint8_t page = y >> 3;
+  uint8_t mask = 1 << (y & 7);
+  uint8_t *dst = &ssd->ram_buffer[ssd1306_index(ssd, x0, page)];
+  uint8_t *end = dst + (x1 - x0 + 1) * ssd->pages;
+  uint8_t stride = ssd->pages;
+  if (value) {
+    for (; dst + 3 * stride < end; dst += 4 * stride) {
+      dst[0] |= mask;
+      dst[stride] |= mask;
+      dst[2 * stride] |= mask;
+      dst[3 * stride] |= mask;
+    }
+    for (; dst < end; dst += stride)
+      *dst |= mask;
+  } else {
+    mask = ~mask;
+    for (; dst + 3 * stride < end; dst += 4 * stride) {
+      dst[0] &= mask;
+      dst[stride] &= mask;
+      dst[2 * stride] &= mask;
+      dst[3 * stride] &= mask;
+    }
+    for (; dst < end; dst += stride)
+      *dst &= mask;
+  }
+  ssd1306_mark_dirty_page(ssd, x0, x1, page);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  if (y0 > y1) {
+    uint8_t t = y0;
+    y0 = y1;
+    y1 = t;
+  }
+  if (x >= ssd->width || y0 >= ssd->height)
+    return;
+  if (y1 >= ssd->height)
+    y1 = ssd->height - 1;
+  ssd1306_fill_area(ssd, x, x, y0, y1, value);
 }
 
 // Função para desenhar um caractere
+// A fonte é organizada por colunas (bit 0 = linha de cima), igual às páginas do
+// display: com y múltiplo de 8 os 8 bytes do glifo são copiados direto; fora do
+// alinhamento cada coluna é dividida em duas páginas com deslocamento e máscara.
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
-  uint16_t index = 0;
+  if (x >= ssd->width || y >= ssd->height)
+    return;
 
-  // Verifica o caractere e calcula o índice correspondente na fonte
-  if (c >= ' ' && c <= '~') // Verifica se o caractere está na faixa ASCII válida
-  {
-    index = (c - ' ') * 8; // Calcula o índice baseado na posição do caractere na tabela ASCII
-  }
-  else
-  {
-    // Caractere inválido, desenha um espaço (ou pode ser tratado de outra forma)
-    index = 0; // Índice 0 corresponde ao caractere "nada" (espaço)
+  // Caractere fora da faixa ASCII imprimível desenha um espaço (índice 0)
+  const uint8_t *glyph = &font[(c >= ' ' && c <= '~') ? (c - ' ') * 8 : 0];
+
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 7;
+  uint8_t cols = (ssd->width - x) < 8 ? (ssd->width - x) : 8;
+  uint8_t *dst = &ssd->ram_buffer[ssd1306_index(ssd, x, page)];
+
+  if (shift == 0) {
+    for (uint8_t i = 0; i < cols; ++i, dst += ssd->pages)
+      *dst = glyph[i];
+    ssd1306_mark_dirty_page(ssd, x, x + cols - 1, page);
+    if (ssd->text_grid && (x & 7) == 0 && cols == 8)
+      ssd->text_cells[page][x >> 3] = c;
+    return;
   }
 
-  // Desenha o caractere na tela
-  for (uint8_t i = 0; i < 8; ++i)
-  {
-    uint8_t line = font[index + i]; // Acessa a linha correspondente do caractere na fonte
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j)); // Desenha cada pixel do caractere
-    }
+  bool second = page + 1 < ssd->pages;
+  uint8_t mask_lo = 0xFF << shift;
+  uint8_t mask_hi = 0xFF >> (8 - shift);
+  for (uint8_t i = 0; i < cols; ++i, dst += ssd->pages) {
+    dst[0] = (dst[0] & ~mask_lo) | (glyph[i] << shift);
+    if (second)
+      dst[1] = (dst[1] & ~mask_hi) | (glyph[i] >> (8 - shift));
   }
+  ssd1306_mark_dirty(ssd, x, x + cols - 1, page, second ? page + 1 : page);
+}
+
+// Liga o modo grade de texto: o driver lembra o caractere de cada célula 8x8
+// alinhada e ssd1306_draw_string pula as células que não mudaram
+void ssd1306_text_grid(ssd1306_t *ssd, bool enable)
+{
+  ssd->text_grid = enable;
+  memset(ssd->text_cells, 0, sizeof(ssd->text_cells)); // 0 = conteúdo desconhecido
 }
 
 // Função para desenhar uma string
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
 {
+  if (y >= ssd->height || x >= ssd->width)
+    return; // Fora da tela; também protege o índice de text_cells
   while (*str)
   {
-    ssd1306_draw_char(ssd, *str++, x, y);
+    char c = *str++;
+    if (!ssd->text_grid || (x & 7) || (y & 7) || ssd->text_cells[y >> 3][x >> 3] != c)
+      ssd1306_draw_char(ssd, c, x, y);
     x += 8;
     if (x + 8 >= ssd->width)
     {
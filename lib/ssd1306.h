@@ -1,9 +1,13 @@
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
 
 #define WIDTH 128
 #define HEIGHT 64
+#define SSD1306_MAX_PAGES 8
+#define SSD1306_CMD_LIST_MAX 32 // comandos por transação em ssd1306_command_list()
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -25,19 +29,55 @@ typedef enum {
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+typedef struct ssd1306 ssd1306_t;
+
+// Sequência de inicialização enviada numa única transação I2C
 typedef struct {
+  const uint8_t *cmds;
+  uint8_t len;
+} ssd1306_profile_t;
+
+extern const ssd1306_profile_t ssd1306_profile_128x64;
+extern const ssd1306_profile_t ssd1306_profile_128x64_ext_vcc;
+extern const ssd1306_profile_t ssd1306_profile_128x32;
+
+// Chamada em contexto de interrupção quando um envio assíncrono termina
+typedef void (*ssd1306_callback_t)(ssd1306_t *ssd, void *arg);
+
+struct ssd1306 {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
   bool external_vcc;
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
-} ssd1306_t;
+  uint8_t *tx_buffer;                      // janela suja montada para envio
+  uint8_t dirty_x0[SSD1306_MAX_PAGES];     // primeira coluna suja de cada página
+  uint8_t dirty_x1[SSD1306_MAX_PAGES];     // última coluna suja (x0 > x1: página limpa)
+  size_t bytes_sent;                       // bytes enviados no último flush
+  uint32_t bytes_total;                    // bytes enviados desde o init
+  int dma_channel;                         // -1: apenas transporte bloqueante
+  uint16_t *dma_buffer;                    // palavras para IC_DATA_CMD
+  volatile bool busy;                      // envio assíncrono em andamento
+  ssd1306_callback_t done_cb;
+  void *done_arg;
+  bool text_grid;                          // cache de células de texto ativo
+  char text_cells[SSD1306_MAX_PAGES][WIDTH / 8]; // caractere de cada célula (0 = desconhecido)
+};
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
+void ssd1306_config_profile(ssd1306_t *ssd, const ssd1306_profile_t *profile);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t len);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1);
+void ssd1306_invalidate(ssd1306_t *ssd);
+
+bool ssd1306_init_dma(ssd1306_t *ssd);
+bool ssd1306_send_data_async(ssd1306_t *ssd, ssd1306_callback_t cb, void *arg);
+bool ssd1306_busy(ssd1306_t *ssd);
+void ssd1306_wait(ssd1306_t *ssd);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -46,4 +86,5 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+void ssd1306_text_grid(ssd1306_t *ssd, bool enable);
\ No newline at end of file
@@ -29,5 +29,8 @@
 
 // This defaults to 4
 #define MQTT_REQ_MAX_IN_FLIGHT 30
+// Defaults to 256: a publicação inteira (tópico + payload de até SAIDA_PAYLOAD_MAX,
+// saida.h) precisa caber no buffer de saída do cliente
+#define MQTT_OUTPUT_RINGBUF_SIZE 1024
 
 #endif
@@ -16,13 +16,22 @@
 #include "hardware/gpio.h"
 #include "hardware/irq.h"
 #include "hardware/adc.h"
-#include "hardware/pwm.h"
 #include "lwip/apps/mqtt.h"
 #include "lwip/apps/mqtt_priv.h"
 #include "lwip/dns.h"
 #include "lwip/altcp_tls.h"
 #include "matrizled.h"
-#include <math.h>
+#include "comodos.h"
+#include "painel.h"
+#include "aquisicao.h"
+#include "sensores.h"
+#include "publicacao.h"
+#include "ciclos.h"
+#include "hal.h"
+#include "aplicacao.h"
+#include "nucleos.h"
+#include "eventos.h"
+#include "saida.h"
 
 #define WIFI_SSID "Tesla"
 #define WIFI_PASSWORD "123456788"
@@ -31,27 +40,14 @@
 #define MQTT_PASSWORD "admin"
 #define MQTT_DEVICE_NAME "pico_cortinas"
 #define MQTT_UNIQUE_TOPIC 0
-#define ADC_PIN 28
+#define ADC_PIN_BASE 26 // GPIO do ADC0; o LDR fica no GPIO 28 (ADC2)
 #define R_CONHECIDO 10000
 #define ADC_VREF 3.3f
 #define ADC_RESOLUTION 4095
 #define botaoB 6
-#define SERVO_PIN 15          // Servo para janela
-#define LIGHT_PIN 14          // Relé/LED para luz
-#define ILUMINACAO_ALVO 65.0f // Iluminação padrão (65%)
-
 #define WS2812_PIN 7     // GPIO para matriz de LEDs WS2812
-#define LED_BLUE_PIN 12  // GPIO12 - LED azul
-#define LED_GREEN_PIN 11 // GPIO11 - LED verde
-#define LED_RED_PIN 13   // GPIO13 - LED vermelho
 #define BUZZER_PIN 10    // Pino do buzzer
 
-int flag = 1;
-
-#ifndef TEMPERATURE_UNITS
-#define TEMPERATURE_UNITS 'C'
-#endif
-
 #ifndef MQTT_SERVER
 #error Need to define MQTT_SERVER
 #endif
@@ -64,7 +60,15 @@ int flag = 1;
 #define MQTT_TOPIC_LEN 100
 #endif
 
-float sala_janela = 0;
+// Assinaturas em voo ao mesmo tempo; abaixo de MQTT_REQ_MAX_IN_FLIGHT (lwipopts.h)
+// para sobrar espaço às publicações
+#define MQTT_SUB_MAX_PENDENTES 8
+
+// Assinar os comandos com curingas ("/casa/+/modo"); cai para tópicos
+// explícitos se o broker recusar
+#ifndef MQTT_ASSINATURA_CURINGA
+#define MQTT_ASSINATURA_CURINGA 1
+#endif
 
 typedef struct
 {
@@ -76,27 +80,15 @@ typedef struct
     ip_addr_t mqtt_server_address;
     bool connect_done;
     int subscribe_count;
+    uint sub_proximo;   // Próximo tópico de topico_assinatura() a enviar
+    uint sub_pendentes; // Assinaturas enviadas sem confirmação
+    bool sub_modo;      // true: assinando, false: cancelando
+    bool assinatura_curinga;  // Filtros "/casa/+/..." em vez de um tópico por cômodo
+    bool assinaturas_prontas;
+    uint64_t conectado_us;    // Instante do CONNACK, para medir o tempo até o último SUBACK
     bool stop_client;
 } MQTT_CLIENT_DATA_T;
 
-// Estado de um cômodo
-typedef struct
-{
-    const char *nome;      // Ex.: "sala"
-    float iluminacao_alvo; // Ex.: 65% (ajustável pelo usuário)
-    float janela_pos;      // 0-100% (abertura)
-    bool luz_ligada;       // Luz on/off
-    bool modo_auto;        // Automático ou manual
-    bool modo_dormir;      // Modo dormir ativo
-} Comodo;
-
-// Definir os cômodos
-static Comodo comodo_sala = {.nome = "sala", .iluminacao_alvo = ILUMINACAO_ALVO, .janela_pos = 0.0f, .luz_ligada = false, .modo_auto = true, .modo_dormir = false};
-static Comodo comodo_quarto1 = {.nome = "quarto1", .iluminacao_alvo = ILUMINACAO_ALVO, .janela_pos = 0.0f, .luz_ligada = false, .modo_auto = true, .modo_dormir = false};
-
-// Variável para alternar o cômodo atual
-static Comodo *comodo_atual = &comodo_sala; // Inicialmente aponta para "sala"
-
 #ifndef DEBUG_printf
 #ifndef NDEBUG
 #define DEBUG_printf printf
@@ -117,18 +109,15 @@ static Comodo *comodo_atual = &comodo_sala; // Inicialmente aponta para "sala"
 #define MQTT_KEEP_ALIVE_S 60
 #define MQTT_SUBSCRIBE_QOS 1
 #define MQTT_PUBLISH_QOS 1
-#define MQTT_PUBLISH_RETAIN 0
 #define MQTT_WILL_TOPIC "/online"
 #define MQTT_WILL_MSG "0"
 #define MQTT_WILL_QOS 1
 
-static float read_onboard_temperature(const char unit);
 static void pub_request_cb(__unused void *arg, err_t err);
 static const char *full_topic(MQTT_CLIENT_DATA_T *state, const char *name);
-static void control_led(MQTT_CLIENT_DATA_T *state, bool on);
-static void publish_temperature(MQTT_CLIENT_DATA_T *state);
 static void sub_request_cb(void *arg, err_t err);
 static void unsub_request_cb(void *arg, err_t err);
+static void sub_curinga_cb(void *arg, err_t err);
 static void sub_unsub_topics(MQTT_CLIENT_DATA_T *state, bool sub);
 static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags);
 static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len);
@@ -137,56 +126,121 @@ static async_at_time_worker_t temperature_worker = {.do_work = temperature_worke
 static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection_status_t status);
 static void start_client(MQTT_CLIENT_DATA_T *state);
 static void dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg);
-static float read_ldr();
-static void publish_light(MQTT_CLIENT_DATA_T *state);
 static void gpio_irq_handler(uint gpio, uint32_t events);
-static void init_servo(void);
-static void set_janela(float pos);
-static void set_luz(bool on);
-static void automacao_iluminacao(MQTT_CLIENT_DATA_T *state);
-static void publish_all_states(MQTT_CLIENT_DATA_T *state);
-static void publish_estado(MQTT_CLIENT_DATA_T *state);
-static void publish_horario(MQTT_CLIENT_DATA_T *state);
-static void publish_janela_estado(MQTT_CLIENT_DATA_T *state);
-static void publish_janela_pos(MQTT_CLIENT_DATA_T *state);
-static void publish_luz_estado(MQTT_CLIENT_DATA_T *state);
+
+static bool mqtt_publicar(const char *topico, const void *payload, uint16_t len, bool retain, SaidaPrioridade prioridade);
+static bool mqtt_enviar(void *contexto, const char *topico, const void *payload, uint16_t len, bool retain);
+static void mqtt_descartada(void *contexto, const char *topico);
+static void encerrar_cliente(void);
+static void iniciar_aplicacao(void);
+static void atualizar_matriz(void);
+static void matriz_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static void botao_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+
+// A matriz redesenha quando a janela ou o cômodo mudam; com NUCLEOS_DUPLO ela é
+// do núcleo 1, que a consulta a cada volta do seu laço em vez de usar o worker
+static EventosAssinante matriz_eventos;
+static async_when_pending_worker_t matriz_worker = {.do_work = matriz_worker_fn};
+static EventosAssinante botao_eventos;
+static async_when_pending_worker_t botao_worker = {.do_work = botao_worker_fn};
+
+// Cliente único: as funções hal_mqtt_* (hal.h) publicam por ele
+static MQTT_CLIENT_DATA_T *cliente_mqtt;
+
+// Sensores, atuadores e a aplicação; com NUCLEOS_DUPLO roda no núcleo 1, para
+// que as interrupções do ADC e da matriz (DMA_IRQ_1) fiquem lá
+static void iniciar_aplicacao(void)
+{
+    adc_init();
+    adc_set_temp_sensor_enabled(true);
+    for (uint i = 0; i < SENSORES_NUM_LDR; i++)
+    {
+        if (SENSORES_ENTRADAS_LDR & (1u << i))
+        {
+            adc_gpio_init(ADC_PIN_BASE + i);
+        }
+    }
+    // Um único fluxo round-robin com os LDRs e o sensor de temperatura
+    init_aquisicao(SENSORES_ENTRADAS_ADC, AQUISICAO_TAXA_PADRAO, AQUISICAO_JANELA_PADRAO);
+    init_sensores(); // Filtros do LDR rodam sobre cada janela do DMA
+
+    init_hal(); // Servo, relé e LED RGB
+
+    PIO pio = pio0;
+    uint offset = pio_add_program(pio, &ws2812_program);
+    ws2812_program_init(pio, 0, offset, WS2812_PIN, 800000, false);
+    init_matriz(pio, 0); // Quadros da matriz passam a ser enviados por DMA
+
+    init_aplicacao();
+}
+
+static void atualizar_matriz(void)
+{
+    uint64_t postado_us;
+    if (eventos_retirar(&matriz_eventos, &postado_us))
+    {
+        acender_matriz_janela(comodo_atual->janela_pos); // Atualiza para o cômodo atual
+        eventos_registrar_latencia(postado_us);          // Comando -> quadro entregue ao DMA
+    }
+}
+
+static void matriz_worker_fn(async_context_t *context, async_when_pending_worker_t *worker)
+{
+    atualizar_matriz();
+}
+
+static void botao_worker_fn(async_context_t *context, async_when_pending_worker_t *worker)
+{
+    if (eventos_retirar(&botao_eventos, NULL) & EVENTO_BOTAO)
+    {
+        reset_usb_boot(0, 0);
+    }
+}
 
 int main(void)
 {
     stdio_init_all();
+    init_ciclos();
+    init_eventos();
     INFO_printf("mqtt client starting\n");
 
-    adc_init();
-    adc_set_temp_sensor_enabled(true);
-    adc_gpio_init(ADC_PIN);
-
     gpio_init(botaoB);
     gpio_set_dir(botaoB, GPIO_IN);
     gpio_pull_up(botaoB);
     gpio_set_irq_enabled_with_callback(botaoB, GPIO_IRQ_EDGE_FALL, true, &gpio_irq_handler);
 
-    init_servo();
-    gpio_init(LIGHT_PIN);
-    gpio_set_dir(LIGHT_PIN, GPIO_OUT);
-    gpio_init(LED_RED_PIN);
-    gpio_set_dir(LED_RED_PIN, GPIO_OUT);
-    gpio_init(LED_GREEN_PIN);
-    gpio_set_dir(LED_GREEN_PIN, GPIO_OUT);
-    gpio_init(LED_BLUE_PIN);
-    gpio_set_dir(LED_BLUE_PIN, GPIO_OUT);
-    set_luz(false);
-
-    PIO pio = pio0;
-    uint offset = pio_add_program(pio, &ws2812_program);
-    ws2812_program_init(pio, 0, offset, WS2812_PIN, 800000, false);
-
     static MQTT_CLIENT_DATA_T state;
+    state.assinatura_curinga = MQTT_ASSINATURA_CURINGA;
+    cliente_mqtt = &state;
+    init_saida(mqtt_enviar, mqtt_descartada, &state);
+#if !NUCLEOS_DUPLO
+    iniciar_aplicacao();
+#endif
 
     if (cyw43_arch_init())
     {
         panic("Failed to initialize CYW43");
     }
 
+    // Produtores postam eventos (eventos.h) e os consumidores rodam como workers
+    async_context_t *contexto = cyw43_arch_async_context();
+    eventos_assinar(&botao_eventos, EVENTO_BOTAO, contexto, &botao_worker);
+#if NUCLEOS_DUPLO
+    eventos_assinar(&matriz_eventos, EVENTO_JANELA | EVENTO_COMODO, NULL, NULL);
+#else
+    eventos_assinar(&matriz_eventos, EVENTO_JANELA | EVENTO_COMODO, contexto, &matriz_worker);
+#endif
+    eventos_postar(EVENTO_COMODO); // Primeiro quadro da matriz
+
+#if NUCLEOS_DUPLO
+    // Sensores, atuadores e a aplicação passam para o núcleo 1
+    init_nucleos(contexto, mqtt_publicar, encerrar_cliente, iniciar_aplicacao, atualizar_matriz);
+#endif
+
+#if PAINEL_OLED
+    init_painel(contexto, comodos, count_of(comodos), &comodo_atual);
+#endif
+
     char unique_id_buf[5];
     pico_get_unique_board_id_string(unique_id_buf, sizeof(unique_id_buf));
     for (int i = 0; i < sizeof(unique_id_buf) - 1; i++)
@@ -251,78 +305,132 @@ int main(void)
         panic("dns request failed");
     }
 
+    // Todo o trabalho roda nas interrupções e nos workers do async_context
+    // (threadsafe_background dispensa cyw43_arch_poll); o núcleo 0 só dorme,
+    // contando o tempo ocioso (nucleos.h), e confere a conexão a cada despertar
     while (!state.connect_done || mqtt_client_is_connected(state.mqtt_client_inst))
     {
-        cyw43_arch_poll();
-        cyw43_arch_wait_for_work_until(make_timeout_time_ms(1000));
-        acender_matriz_janela(comodo_atual->janela_pos); // Atualiza para o cômodo atual
+        nucleos_dormir_ate(at_the_end_of_time);
     }
 
     INFO_printf("mqtt client exiting\n");
     return 0;
 }
 
-static float read_onboard_temperature(const char unit)
-{
-    adc_select_input(4);
-    const float conversionFactor = 3.3f / (1 << 12);
-    float adc = (float)adc_read() * conversionFactor;
-    float tempC = 27.0f - (adc - 0.706f) / 0.001721f;
-
-    if (unit == 'C' || unit != 'F')
-    {
-        return tempC;
-    }
-    else if (unit == 'F')
-    {
-        return tempC * 9 / 5 + 32;
-    }
-
-    return -1.0f;
-}
-
+// Fim de uma publicação (PUBACK, erro ou timeout): libera a vez para a próxima da fila
 static void pub_request_cb(__unused void *arg, err_t err)
 {
     if (err != 0)
     {
         ERROR_printf("pub_request_cb failed %d", err);
     }
+    saida_concluida(err == ERR_OK);
 }
 
 static const char *full_topic(MQTT_CLIENT_DATA_T *state, const char *name)
 {
 #if MQTT_UNIQUE_TOPIC
-    static char full_topic[MQTT_TOPIC_LEN];
-    snprintf(full_topic, sizeof(full_topic), "/%s%s", state->mqtt_client_info.client_id, name);
-    return full_topic;
+    // Um buffer por núcleo: com NUCLEOS_DUPLO a aplicação monta tópicos no núcleo 1
+    static char full_topic[NUM_CORES][MQTT_TOPIC_LEN];
+    char *topico = full_topic[get_core_num()];
+    snprintf(topico, MQTT_TOPIC_LEN, "/%s%s", state->mqtt_client_info.client_id, name);
+    return topico;
 #else
     return name;
 #endif
 }
 
-static void control_led(MQTT_CLIENT_DATA_T *state, bool on)
+// Tudo passa pela fila de saída (saida.h), que limita as requisições no lwIP
+static bool mqtt_publicar(const char *topico, const void *payload, uint16_t len, bool retain, SaidaPrioridade prioridade)
 {
-    const char *message = on ? "On" : "Off";
-    if (on)
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1);
-    else
-        cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0);
+    return saida_enfileirar(topico, payload, len, retain, prioridade);
+}
+
+static bool mqtt_enviar(void *contexto, const char *topico, const void *payload, uint16_t len, bool retain)
+{
+    MQTT_CLIENT_DATA_T *state = contexto;
+    return mqtt_publish(state->mqtt_client_inst, topico, payload, len, MQTT_PUBLISH_QOS, retain, pub_request_cb, state) == ERR_OK;
+}
+
+// A fila descartou uma publicação já aceita: a aplicação a reenvia no próximo ciclo
+static void mqtt_descartada(__unused void *contexto, const char *topico)
+{
+#if NUCLEOS_DUPLO
+    nucleos_descartada(topico);
+#else
+    aplicacao_descartada(topico);
+#endif
+}
+
+static void encerrar_cliente(void)
+{
+    cliente_mqtt->stop_client = true;
+    sub_unsub_topics(cliente_mqtt, false);
+}
+
+const char *hal_mqtt_topico(const char *nome)
+{
+    return full_topic(cliente_mqtt, nome);
+}
+
+// Com NUCLEOS_DUPLO a aplicação publica pelo anel de nucleos.c
+#if !NUCLEOS_DUPLO
+bool hal_mqtt_publicar(const char *topico, const void *payload, uint16_t len, bool retain, SaidaPrioridade prioridade)
+{
+    return mqtt_publicar(topico, payload, len, retain, prioridade);
+}
 
-    mqtt_publish(state->mqtt_client_inst, full_topic(state, "/led/state"), message, strlen(message), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+void hal_mqtt_encerrar(void)
+{
+    encerrar_cliente();
 }
+#endif
 
-static void publish_temperature(MQTT_CLIENT_DATA_T *state)
+// Tópico único para seleção de cômodo + comandos dos cômodos (comodos.c): com
+// curingas, um filtro "/casa/+/<caminho>" por comando, independente do número
+// de cômodos; o roteador filtra localmente os cômodos que não existem
+static uint total_assinaturas(const MQTT_CLIENT_DATA_T *state)
 {
-    static float old_temperature;
-    const char *temperature_key = full_topic(state, "/temperature");
-    float temperature = read_onboard_temperature(TEMPERATURE_UNITS);
-    if (temperature != old_temperature)
+    return 1 + (state->assinatura_curinga ? comodos_num_assinaturas_curinga : comodos_num_assinaturas);
+}
+
+static const char *topico_assinatura(const MQTT_CLIENT_DATA_T *state, uint indice)
+{
+    if (indice == 0)
     {
-        old_temperature = temperature;
-        char temp_str[16];
-        snprintf(temp_str, sizeof(temp_str), "%.2f", temperature);
-        INFO_printf("Publishing %s to %s\n", temp_str, temperature_key);
-        mqtt_publish(state->mqtt_client_inst, temperature_key, temp_str, strlen(temp_str), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+        return "/casa/select";
+    }
+    return state->assinatura_curinga ? comodos_assinaturas_curinga[indice - 1] : comodos_assinaturas[indice - 1];
+}
+
+// Com muitos cômodos as assinaturas passam do limite de requisições em voo do
+// lwIP; elas são enviadas em lotes e cada confirmação libera a próxima
+static void enviar_assinaturas(MQTT_CLIENT_DATA_T *state)
+{
+    mqtt_request_cb_t cb = !state->sub_modo ? unsub_request_cb : state->assinatura_curinga ? sub_curinga_cb
+                                                                                           : sub_request_cb;
+    uint total = total_assinaturas(state);
+    while (state->sub_proximo < total && state->sub_pendentes < MQTT_SUB_MAX_PENDENTES)
+    {
+        err_t err = mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, topico_assinatura(state, state->sub_proximo)), MQTT_SUBSCRIBE_QOS, cb, state, state->sub_modo);
+        if (err != ERR_OK)
+        {
+            if (state->sub_pendentes == 0)
+            {
+                panic("subscribe request failed %d", err);
+            }
+            break; // Tenta de novo na próxima confirmação
+        }
+        state->sub_proximo++;
+        state->sub_pendentes++;
+    }
+
+    // Tempo do CONNACK até o último SUBACK
+    if (state->sub_modo && !state->assinaturas_prontas && state->sub_proximo == total && state->sub_pendentes == 0)
+    {
+        state->assinaturas_prontas = true;
+        INFO_printf("Subscriptions ready in %u ms (%s, %u requests)\n",
+                    (unsigned)((time_us_64() - state->conectado_us) / 1000), state->assinatura_curinga ? "wildcard" : "explicit", total);
     }
 }
 
@@ -334,6 +442,29 @@ static void sub_request_cb(void *arg, err_t err)
         panic("subscribe request failed %d", err);
     }
     state->subscribe_count++;
+    state->sub_pendentes--;
+    enviar_assinaturas(state);
+}
+
+// Brokers com ACL podem recusar filtros com curinga: na primeira recusa as
+// assinaturas recomeçam com os tópicos explícitos, e o modo fica assim nas
+// próximas conexões. Filtros curinga já aceitos continuam valendo; mensagens
+// repetidas não mudam o estado, pois todo comando define um valor absoluto.
+static void sub_curinga_cb(void *arg, err_t err)
+{
+    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
+    state->sub_pendentes--;
+    if (err == ERR_OK)
+    {
+        state->subscribe_count++;
+    }
+    else if (state->assinatura_curinga)
+    {
+        INFO_printf("Wildcard subscription refused (%d), falling back to explicit topics\n", err);
+        state->assinatura_curinga = false;
+        state->sub_proximo = 0;
+    }
+    enviar_assinaturas(state);
 }
 
 static void unsub_request_cb(void *arg, err_t err)
@@ -344,6 +475,8 @@ static void unsub_request_cb(void *arg, err_t err)
         panic("unsubscribe request failed %d", err);
     }
     state->subscribe_count--;
+    state->sub_pendentes--;
+    enviar_assinaturas(state);
 
     if (state->subscribe_count <= 0 && state->stop_client)
     {
@@ -351,36 +484,14 @@ static void unsub_request_cb(void *arg, err_t err)
     }
 }
 
-
 static void sub_unsub_topics(MQTT_CLIENT_DATA_T *state, bool sub)
 {
-    mqtt_request_cb_t cb = sub ? sub_request_cb : unsub_request_cb;
-    // Tópico único para seleção de cômodo
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/select"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-
-    // Tópicos para "sala"
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/sala/luz/set"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/sala/janela/set"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/sala/janela/abrir"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/sala/luz/ligar"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/sala/modo"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/sala/modo_dormir"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/sala/janela/estado"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-
-    // Tópicos para "quarto1"
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/quarto1/luz/set"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/quarto1/janela/set"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/quarto1/janela/abrir"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/quarto1/luz/ligar"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/quarto1/modo"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/quarto1/modo_dormir"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
-    mqtt_sub_unsub(state->mqtt_client_inst, full_topic(state, "/casa/quarto1/janela/estado"), MQTT_SUBSCRIBE_QOS, cb, state, sub);
+    state->sub_modo = sub;
+    state->sub_proximo = 0;
+    state->assinaturas_prontas = false;
+    enviar_assinaturas(state);
 }
 
-
-// Variável estática para evitar reentrância no processamento de modo
-static bool publicando_modo = false;
-
 static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t flags)
 {
     MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
@@ -396,237 +507,16 @@ static void mqtt_incoming_data_cb(void *arg, const u8_t *data, u16_t len, u8_t f
     DEBUG_printf("Topic: %s, Message: %s\n", state->topic, state->data);
     DEBUG_printf("After processing %s: %s, %s\n", state->topic, state->data, basic_topic);
 
-    // Extrair o nome do cômodo do tópico (ex.: "sala" ou "quarto1")
-    char comodo_do_topico[16] = {0};
-    if (strncmp(basic_topic, "/casa/", 6) == 0) {
-        const char *ptr = basic_topic + 6; // Após "/casa/"
-        const char *end = strchr(ptr, '/');
-        if (end) {
-            size_t len = end - ptr;
-            strncpy(comodo_do_topico, ptr, len);
-            comodo_do_topico[len] = '\0';
-        }
-    }
-
-    // Removido o trecho que verifica se o comando é para o cômodo atual, pois a lógica foi redistribuída nos blocos de comando
-
-    if (strcmp(basic_topic, "/led") == 0)
-    {
-        if (lwip_stricmp((const char *)state->data, "on") == 0 || strcmp((const char *)state->data, "1") == 0)
-        {
-            INFO_printf("Received /led: %s\n", state->data);
-            control_led(state, true);
-        }
-        else if (lwip_stricmp((const char *)state->data, "off") == 0 || strcmp((const char *)state->data, "0") == 0)
-        {
-            INFO_printf("Received /led: %s\n", state->data);
-            control_led(state, false);
-        }
-    }
-    else if (strcmp(basic_topic, "/print") == 0)
-    {
-        INFO_printf("Received /print: %.*s\n", len, state->data);
-        INFO_printf("%.*s\n", len, state->data);
-    }
-    else if (strcmp(basic_topic, "/ping") == 0)
-    {
-        INFO_printf("Received /ping\n");
-        char buffer[32];
-        snprintf(buffer, sizeof(buffer), "%u", to_ms_since_boot(get_absolute_time()) / 1000);
-        mqtt_publish(state->mqtt_client_inst, full_topic(state, "/uptime"), buffer, strlen(buffer), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
-    }
-    else if (strcmp(basic_topic, "/exit") == 0)
-    {
-        INFO_printf("Received /exit\n");
-        state->stop_client = true;
-        sub_unsub_topics(state, false);
-    }
-    else if (strcmp(basic_topic, "/casa/select") == 0)
-    {
-        INFO_printf("Received /casa/select with payload: '%s'\n", state->data);
-        
-        // Remover a barra inicial, se presente
-        const char *payload = state->data;
-        if (payload[0] == '/') {
-            payload++; // Avança o ponteiro para ignorar o '/'
-        }
-
-        if (strcmp(payload, "sala") == 0)
-        {
-            INFO_printf("Switching to comodo: sala\n");
-            comodo_atual = &comodo_sala;
-            publish_all_states(state);
-        }
-        else if (strcmp(payload, "quarto1") == 0)
-        {
-            INFO_printf("Switching to comodo: quarto1\n");
-            comodo_atual = &comodo_quarto1;
-            publish_all_states(state);
-        }
-        else
-        {
-            INFO_printf("Selection ignored: unknown payload='%s'\n", payload);
-        }
-    }
-    else if (strcmp(basic_topic, "/casa/sala/luz/set") == 0 || strcmp(basic_topic, "/casa/quarto1/luz/set") == 0)
-    {
-        float nova_alvo = atof((const char *)state->data);
-        if (nova_alvo >= 0.0f && nova_alvo <= 100.0f)
-        {
-            INFO_printf("Received %s: %.2f\n", basic_topic, nova_alvo);
-            // Identificar o cômodo alvo
-            bool is_sala = strstr(basic_topic, "sala") != NULL;
-            Comodo *target_comodo = is_sala ? &comodo_sala : &comodo_quarto1;
-            target_comodo->iluminacao_alvo = nova_alvo;
-            publish_estado(state); // Publicar o novo valor no estado do cômodo alvo
-        }
-    }
-    else if (strcmp(basic_topic, "/casa/sala/janela/set") == 0 || strcmp(basic_topic, "/casa/quarto1/janela/set") == 0)
-    {
-        // Identificar o cômodo alvo
-        bool is_sala = strstr(basic_topic, "sala") != NULL;
-        Comodo *target_comodo = is_sala ? &comodo_sala : &comodo_quarto1;
-        if (!target_comodo->modo_dormir && !target_comodo->modo_auto)
-        {
-            float nova_pos = atof((const char *)state->data);
-            if (nova_pos >= 0.0f && nova_pos <= 100.0f)
-            {
-                INFO_printf("Received %s: %.2f\n", basic_topic, nova_pos);
-                target_comodo->janela_pos = nova_pos;
-                set_janela(nova_pos);
-                publish_all_states(state);
-                sala_janela = nova_pos; // Ajuste global (a ser revisado se houver múltiplos servos)
-            }
-        }
-        else
-        {
-            INFO_printf("Command ignored: modo_dormir=%d or modo_auto=%d for %s\n", target_comodo->modo_dormir, target_comodo->modo_auto, target_comodo->nome);
-        }
-    }
-    else if (strcmp(basic_topic, "/casa/sala/janela/abrir") == 0 || strcmp(basic_topic, "/casa/quarto1/janela/abrir") == 0)
-    {
-        // Identificar o cômodo alvo
-        bool is_sala = strstr(basic_topic, "sala") != NULL;
-        Comodo *target_comodo = is_sala ? &comodo_sala : &comodo_quarto1;
-        if (!target_comodo->modo_dormir && !target_comodo->modo_auto)
-        {
-            if (lwip_stricmp((const char *)state->data, "on") == 0)
-            {
-                INFO_printf("Received %s: on\n", basic_topic);
-                target_comodo->janela_pos = 100.0f;
-                set_janela(100.0f);
-                sala_janela = 100.0f;
-            }
-            else if (lwip_stricmp((const char *)state->data, "off") == 0)
-            {
-                INFO_printf("Received %s: off\n", basic_topic);
-                target_comodo->janela_pos = 0.0f;
-                set_janela(0.0f);
-                sala_janela = 0.0f;
-            }
-            publish_all_states(state);
-        }
-        else
-        {
-            INFO_printf("Command ignored: modo_dormir=%d or modo_auto=%d for %s\n", target_comodo->modo_dormir, target_comodo->modo_auto, target_comodo->nome);
-        }
-    }
-    else if (strcmp(basic_topic, "/casa/sala/luz/ligar") == 0 || strcmp(basic_topic, "/casa/quarto1/luz/ligar") == 0)
-    {
-        // Identificar o cômodo alvo
-        bool is_sala = strstr(basic_topic, "sala") != NULL;
-        Comodo *target_comodo = is_sala ? &comodo_sala : &comodo_quarto1;
-        if (!target_comodo->modo_dormir && !target_comodo->modo_auto)
-        {
-            if (lwip_stricmp((const char *)state->data, "on") == 0)
-            {
-                INFO_printf("Received %s: on\n", basic_topic);
-                set_luz(true);
-                target_comodo->luz_ligada = true;
-            }
-            else if (lwip_stricmp((const char *)state->data, "off") == 0)
-            {
-                INFO_printf("Received %s: off\n", basic_topic);
-                set_luz(false);
-                target_comodo->luz_ligada = false;
-            }
-            publish_all_states(state);
-        }
-        else
-        {
-            INFO_printf("Command ignored: modo_dormir=%d or modo_auto=%d for %s\n", target_comodo->modo_dormir, target_comodo->modo_auto, target_comodo->nome);
-        }
-    }
-    else if (strcmp(basic_topic, "/casa/sala/modo") == 0 || strcmp(basic_topic, "/casa/quarto1/modo") == 0)
+#if NUCLEOS_DUPLO
+    if (!nucleos_mensagem(basic_topic, state->data))
     {
-        // Identificar o cômodo alvo
-        bool is_sala = strstr(basic_topic, "sala") != NULL;
-        Comodo *target_comodo = is_sala ? &comodo_sala : &comodo_quarto1;
-        if (!target_comodo->modo_dormir && !publicando_modo)
-        {
-            publicando_modo = true;
-            if (lwip_stricmp((const char *)state->data, "auto") == 0)
-            {
-                INFO_printf("Received %s: auto\n", basic_topic);
-                flag = 1;
-                target_comodo->modo_auto = true;
-            }
-            else if (lwip_stricmp((const char *)state->data, "manual") == 0)
-            {
-                INFO_printf("Received %s: manual\n", basic_topic);
-                target_comodo->modo_auto = false;
-            }
-            publish_all_states(state);
-            publicando_modo = false;
-        }
-        else
-        {
-            INFO_printf("Command ignored: modo_dormir=%d for %s\n", target_comodo->modo_dormir, target_comodo->nome);
-        }
-    }
-    else if (strcmp(basic_topic, "/casa/sala/modo_dormir") == 0 || strcmp(basic_topic, "/casa/quarto1/modo_dormir") == 0)
-    {
-        // Identificar o cômodo alvo
-        bool is_sala = strstr(basic_topic, "sala") != NULL;
-        Comodo *target_comodo = is_sala ? &comodo_sala : &comodo_quarto1;
-        if (strcmp((const char *)state->data, "on") == 0)
-        {
-            INFO_printf("Received %s: on\n", basic_topic);
-            target_comodo->modo_dormir = true;
-            set_luz(false);
-            target_comodo->luz_ligada = false;
-            publish_luz_estado(state);
-            set_janela(0.0f);
-            target_comodo->janela_pos = 0.0f;
-            target_comodo->modo_auto = false;
-            sala_janela = 0.0f;
-            if (!publicando_modo)
-            {
-                publicando_modo = true;
-                mqtt_publish(state->mqtt_client_inst, full_topic(state, basic_topic), "manual", strlen("manual"), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
-                publicando_modo = false;
-            }
-            publish_all_states(state);
-        }
-        else if (strcmp((const char *)state->data, "off") == 0)
-        {
-            INFO_printf("Received %s: off\n", basic_topic);
-            target_comodo->modo_dormir = false;
-            flag = 1;
-            target_comodo->modo_auto = true;
-            if (!publicando_modo)
-            {
-                publicando_modo = true;
-                mqtt_publish(state->mqtt_client_inst, full_topic(state, basic_topic), "auto", strlen("auto"), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
-                publicando_modo = false;
-            }
-            publish_all_states(state);
-        }
+        ERROR_printf("Core 1 queue full, dropping %s\n", basic_topic);
     }
+#else
+    aplicacao_mensagem(basic_topic, state->data);
+#endif
 }
 
-
-
 static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len)
 {
     MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)arg;
@@ -635,16 +525,23 @@ static void mqtt_incoming_publish_cb(void *arg, const char *topic, u32_t tot_len
 
 static void temperature_worker_fn(async_context_t *context, async_at_time_worker_t *worker)
 {
-    MQTT_CLIENT_DATA_T *state = (MQTT_CLIENT_DATA_T *)worker->user_data;
-    publish_temperature(state);
-    publish_light(state);
-    publish_horario(state);
-    if (comodo_atual->modo_auto && !comodo_atual->modo_dormir)
-    {
-        automacao_iluminacao(state);
-    }
-    // Publicar todos os estados periodicamente, independentemente de mudanças
-    publish_all_states(state);
+#if !NUCLEOS_DUPLO
+    aplicacao_ciclo(); // Com NUCLEOS_DUPLO, no laço do núcleo 1
+#endif
+    NucleosContadores nucleos;
+    nucleos_contadores(&nucleos);
+    EventosLatencia latencia;
+    eventos_latencia(&latencia);
+    DEBUG_printf("eventos: %u quadros da matriz, latencia media %u us max %u us\n", latencia.amostras,
+                 latencia.media_us, latencia.max_us);
+    DEBUG_printf("nucleos: uso %u%% / %u%%, entrada %u max %u perdidas, saida %u max %u recusadas %u falhas\n",
+                 nucleos.uso[0], nucleos.uso[1], nucleos.entrada_max, nucleos.entrada_perdidas, nucleos.saida_max,
+                 nucleos.saida_recusadas, nucleos.saida_falhas);
+    SaidaContadores saida;
+    saida_contadores(&saida);
+    DEBUG_printf("saida: fila %u max %u, %u em voo, %u enviadas, %u mescladas, %u descartadas, %u adiadas, %u falhas\n",
+                 saida.profundidade, saida.profundidade_max, saida.em_voo, saida.enviadas, saida.mescladas,
+                 saida.descartadas, saida.adiadas, saida.falhas);
     async_context_add_at_time_worker_in_ms(context, worker, TEMP_WORKER_TIME_S * 1000);
 }
 
@@ -654,25 +551,20 @@ static void mqtt_connection_cb(mqtt_client_t *client, void *arg, mqtt_connection
     if (status == MQTT_CONNECT_ACCEPTED)
     {
         state->connect_done = true;
+        state->conectado_us = time_us_64();
+        saida_reiniciar(); // Requisições da sessão anterior não terminam mais
         sub_unsub_topics(state, true);
 
         if (state->mqtt_client_info.will_topic)
         {
-            mqtt_publish(state->mqtt_client_inst, state->mqtt_client_info.will_topic, "1", 1, MQTT_WILL_QOS, true, pub_request_cb, state);
+            mqtt_publicar(state->mqtt_client_info.will_topic, "1", 1, true, SAIDA_ESTADO);
         }
 
-        // Garantir os estados iniciais e publicar explicitamente
-        flag = 1;
-        comodo_atual->modo_auto = true; // Confirmar modo automático no início
-        mqtt_publish(state->mqtt_client_inst, full_topic(state, "/casa/sala/modo"), "auto", strlen("auto"), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
-        comodo_atual->modo_dormir = false; // Confirmar modo dormir desativado no início
-        mqtt_publish(state->mqtt_client_inst, full_topic(state, "/casa/sala/modo_dormir"), "off", strlen("off"), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
-        publish_all_states(state); // Publicar todos os estados iniciais, incluindo modo e modo_dormir
-
-        // Publicar o valor padrão de iluminacao_alvo no tópico /casa/sala/luz/set
-        char alvo_str[16];
-        snprintf(alvo_str, sizeof(alvo_str), "%.2f", ILUMINACAO_ALVO);
-        mqtt_publish(state->mqtt_client_inst, full_topic(state, "/casa/sala/luz/set"), alvo_str, strlen(alvo_str), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
+#if NUCLEOS_DUPLO
+        nucleos_conectado();
+#else
+        aplicacao_conectado();
+#endif
 
         temperature_worker.user_data = state;
         async_context_add_at_time_worker_in_ms(cyw43_arch_async_context(), &temperature_worker, 0);
@@ -734,226 +626,10 @@ static void dns_found(const char *hostname, const ip_addr_t *ipaddr, void *arg)
     }
 }
 
-static float read_ldr()
-{
-    adc_select_input(2);
-    float soma = 0.0f;
-    for (int i = 0; i < 100; i++)
-    {
-        soma += adc_read();
-        sleep_ms(1);
-    }
-    float media = soma / 100.0f;
-
-    float adc_min = 100.0f;
-    float adc_max = 4000.0f;
-    float light = 100.0f * (adc_max - media) / (adc_max - adc_min);
-    light = light < 0.0f ? 0.0f : light > 100.0f ? 100.0f
-                                                 : light;
-
-    return light;
-}
-
-static void publish_light(MQTT_CLIENT_DATA_T *state)
-{
-    static float old_light = -1.0f;
-    char light_key[MQTT_TOPIC_LEN];
-    snprintf(light_key, sizeof(light_key), "/casa/%s/luz", comodo_atual->nome);
-    float light = read_ldr();
-    if (fabs(light - old_light) > 0.5f)
-    {
-        old_light = light;
-        char light_str[16];
-        snprintf(light_str, sizeof(light_str), "%.2f", light);
-        INFO_printf("Publishing %s to %s\n", light_str, light_key);
-        mqtt_publish(state->mqtt_client_inst, light_key, light_str, strlen(light_str), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
-    }
-}
-
 static void gpio_irq_handler(uint gpio, uint32_t events)
 {
     if (gpio == botaoB && events & GPIO_IRQ_EDGE_FALL)
     {
-        reset_usb_boot(0, 0);
-    }
-}
-
-static void init_servo(void)
-{
-    gpio_set_function(SERVO_PIN, GPIO_FUNC_PWM);
-    uint slice_num = pwm_gpio_to_slice_num(SERVO_PIN);
-    pwm_config config = pwm_get_default_config();
-    pwm_config_set_clkdiv(&config, 125.0f); // 1MHz
-    pwm_config_set_wrap(&config, 20000);    // 20ms
-    pwm_init(slice_num, &config, true);
-    set_janela(0.0f); // Inicia fechada
-}
-
-static void set_janela(float pos)
-{
-    pos = pos < 0.0f ? 0.0f : pos > 100.0f ? 100.0f
-                                           : pos;
-    uint16_t pulse = 500 + (pos * 2000 / 100); // 500us (0°) to 2500us (180°)
-    pwm_set_gpio_level(SERVO_PIN, pulse);
-    comodo_atual->janela_pos = pos;
-    sala_janela = pos; // Atualizar variável global
-    // acender_matriz_janela(sala_janela); // Comentado conforme sua alteração
-}
-
-static void set_luz(bool on)
-{
-    gpio_put(LIGHT_PIN, on ? 1 : 0);
-    if (on)
-    {
-        gpio_put(LED_RED_PIN, 1);
-        gpio_put(LED_GREEN_PIN, 1);
-        gpio_put(LED_BLUE_PIN, 1);
+        eventos_postar(EVENTO_BOTAO); // O reset sai do worker, fora da interrupção
     }
-    else
-    {
-        gpio_put(LED_RED_PIN, 0);
-        gpio_put(LED_GREEN_PIN, 0);
-        gpio_put(LED_BLUE_PIN, 0);
-    }
-    comodo_atual->luz_ligada = on;
 }
-
-static void automacao_iluminacao(MQTT_CLIENT_DATA_T *state)
-{
-    float luz_atual = read_ldr();
-    float alvo = comodo_atual->iluminacao_alvo;
-    float tolerancia = 2.0f; // Tolerância de ±2%
-    float diferenca = fabs(luz_atual - alvo);
-    float incremento;
-
-    // Escolher incremento adaptativo baseado na diferença
-    if (diferenca > 20.0f)
-    {
-        incremento = 5.0f; // Incremento maior para diferenças grandes
-    }
-    else if (diferenca > 10.0f)
-    {
-        incremento = 2.0f; // Incremento médio para diferenças moderadas
-    }
-    else
-    {
-        incremento = 1.0f; // Incremento pequeno perto do alvo
-    }
-
-    // Ajustar a janela para maximizar a luz natural
-    if (diferenca > tolerancia)
-    {
-        if (luz_atual < (alvo - tolerancia) && comodo_atual->janela_pos < 100.0f)
-        {
-            comodo_atual->janela_pos += incremento;
-            if (comodo_atual->janela_pos > 100.0f)
-                comodo_atual->janela_pos = 100.0f;
-            set_janela(comodo_atual->janela_pos);
-            sala_janela = comodo_atual->janela_pos;
-            publish_all_states(state);
-            sleep_ms(100);          // Atraso para estabilizar a leitura
-            luz_atual = read_ldr(); // Atualizar leitura após ajustar
-            diferenca = fabs(luz_atual - alvo);
-        }
-        else if (luz_atual > (alvo + tolerancia) && comodo_atual->janela_pos > 0.0f)
-        {
-            comodo_atual->janela_pos -= incremento;
-            if (comodo_atual->janela_pos < 0.0f)
-                comodo_atual->janela_pos = 0.0f;
-            set_janela(comodo_atual->janela_pos);
-            sala_janela = comodo_atual->janela_pos;
-            publish_all_states(state);
-            sleep_ms(100);          // Atraso para estabilizar a leitura
-            luz_atual = read_ldr(); // Atualizar leitura após ajustar
-            diferenca = fabs(luz_atual - alvo);
-        }
-
-        // Desligar a luz se a iluminação for suficiente após ajustar a janela
-        if (comodo_atual->luz_ligada && luz_atual >= (alvo - tolerancia))
-        {
-            set_luz(false);
-            comodo_atual->luz_ligada = false;
-            publish_all_states(state);
-            sleep_ms(100);          // Atraso para estabilizar a leitura
-            luz_atual = read_ldr(); // Atualizar leitura após desligar
-            diferenca = fabs(luz_atual - alvo);
-        }
-    }
-    // Ligar a luz apenas se a janela estiver totalmente aberta e ainda for insuficiente
-    if ((diferenca > tolerancia) && (comodo_atual->janela_pos >= 100.0f) && !comodo_atual->luz_ligada && flag)
-    {
-        set_luz(true);
-        comodo_atual->luz_ligada = true;
-        publish_all_states(state);
-        printf("eu mandei ligar\n");
-        flag = 0;
-    }
-
-    if (flag)
-    {
-        set_luz(false);
-        comodo_atual->luz_ligada = false;
-        publish_all_states(state);
-        printf("eu mandei desligar\n");
-    }
-    publish_all_states(state);
-}
-
-static void publish_estado(MQTT_CLIENT_DATA_T *state)
-{
-    char estado_key[MQTT_TOPIC_LEN];
-    snprintf(estado_key, sizeof(estado_key), "/casa/%s/estado", comodo_atual->nome);
-    char estado_str[128];
-    snprintf(estado_str, sizeof(estado_str),
-             "{\"luz\":%.2f,\"janela\":%.2f,\"luz_ligada\":%d,\"modo\":\"%s\",\"modo_dormir\":%d,\"iluminacao_alvo\":%.2f}",
-             read_ldr(), comodo_atual->janela_pos, comodo_atual->luz_ligada, comodo_atual->modo_auto ? "auto" : "manual", comodo_atual->modo_dormir, comodo_atual->iluminacao_alvo);
-    mqtt_publish(state->mqtt_client_inst, estado_key, estado_str, strlen(estado_str), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
-}
-
-static void publish_all_states(MQTT_CLIENT_DATA_T *state)
-{
-    publish_estado(state); // Publica o estado geral, incluindo o modo
-    publish_janela_estado(state);
-    publish_janela_pos(state);
-    publish_luz_estado(state);
-}
-
-static void publish_janela_estado(MQTT_CLIENT_DATA_T *state)
-{
-    char janela_estado_key[MQTT_TOPIC_LEN];
-    snprintf(janela_estado_key, sizeof(janela_estado_key), "/casa/%s/janela/estado", comodo_atual->nome);
-    const char *estado = (comodo_atual->janela_pos > 0.0f) ? "on" : "off";
-    INFO_printf("Publishing to %s: %s\n", janela_estado_key, estado);
-    mqtt_publish(state->mqtt_client_inst, janela_estado_key, estado, strlen(estado), MQTT_PUBLISH_QOS, 1, pub_request_cb, state);
-}
-
-static void publish_janela_pos(MQTT_CLIENT_DATA_T *state)
-{
-    char janela_pos_key[MQTT_TOPIC_LEN];
-    snprintf(janela_pos_key, sizeof(janela_pos_key), "/casa/%s/janela/pos", comodo_atual->nome);
-    char pos_str[16];
-    snprintf(pos_str, sizeof(pos_str), "%.2f", comodo_atual->janela_pos);
-    INFO_printf("Publishing to %s: %s\n", janela_pos_key, pos_str);
-    mqtt_publish(state->mqtt_client_inst, janela_pos_key, pos_str, strlen(pos_str), MQTT_PUBLISH_QOS, 1, pub_request_cb, state);
-}
-
-static void publish_luz_estado(MQTT_CLIENT_DATA_T *state)
-{
-    char luz_estado_key[MQTT_TOPIC_LEN];
-    snprintf(luz_estado_key, sizeof(luz_estado_key), "/casa/%s/luz/estado", comodo_atual->nome);
-    const char *estado = comodo_atual->luz_ligada ? "on" : "off";
-    INFO_printf("Publishing to %s: %s\n", luz_estado_key, estado);
-    mqtt_publish(state->mqtt_client_inst, luz_estado_key, estado, strlen(estado), MQTT_PUBLISH_QOS, 1, pub_request_cb, state);
-}
-
-static void publish_horario(MQTT_CLIENT_DATA_T *state)
-{
-    absolute_time_t now = get_absolute_time();
-    uint64_t us = to_us_since_boot(now);
-    uint32_t seconds = us / 1000000;
-    uint32_t hours = (seconds / 3600) % 24;
-    uint32_t minutes = (seconds / 60) % 60;
-    char horario_str[16];
-    snprintf(horario_str, sizeof(horario_str), "%02u:%02u", hours, minutes);
-    mqtt_publish(state->mqtt_client_inst, full_topic(state, "/casa/horario"), horario_str, strlen(horario_str), MQTT_PUBLISH_QOS, MQTT_PUBLISH_RETAIN, pub_request_cb, state);
-}
\ No newline at end of file
@@ -1,14 +1,31 @@
 #include "matrizled.h"
-#include "pico/stdlib.h" // Para sleep_us
+#include "pico/stdlib.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+#define MATRIZ_NUM_PIXELS 25
+#define MATRIZ_US_POR_PIXEL 30     // 24 bits a 800 kHz
+#define MATRIZ_RESET_US 100        // silêncio de latch (mais que o mínimo de 50µs requerido)
 
 // Variável estática para armazenar o último valor de abertura
-static float ultima_abertura = -1.0f;
+static int32_t ultima_abertura = -1; // -1: nada desenhado ainda
 
-// Função auxiliar para enviar um pixel à matriz WS2812
-static inline void put_pixel(uint32_t pixel_grb)
-{
-    pio_sm_put_blocking(pio0, 0, pixel_grb << 8u); // Envia o valor RGB ao PIO
-}
+// Quadros duplos: o DMA lê o quadro da frente enquanto a CPU escreve no de trás
+static uint32_t quadros[2][MATRIZ_NUM_PIXELS];
+static volatile uint8_t quadro_frente = 0;
+static volatile bool transmitindo = false;
+static volatile bool quadro_pendente = false;
+
+static PIO matriz_pio;
+static uint matriz_sm;
+static int canal_dma = -1;
+// Os alarmes rodam no núcleo 0 e, com NUCLEOS_DUPLO, a matriz é desenhada no
+// núcleo 1: a troca de quadros é protegida por uma trava de hardware, não só
+// pelas interrupções do núcleo atual
+static spin_lock_t *trava;
+static matriz_callback_t matriz_callback = NULL;
+static void *matriz_callback_arg = NULL;
 
 // Função auxiliar para converter valores RGB em formato de 32 bits para a matriz WS2812
 static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b)
@@ -16,45 +33,143 @@ static inline uint32_t urgb_u32(uint8_t r, uint8_t g, uint8_t b)
     return ((uint32_t)(r) << 8) | ((uint32_t)(g) << 16) | (uint32_t)(b); // Combina R, G e B em um único valor
 }
 
-void acender_matriz_janela(float abertura) {
+// Tempo até o último pixel sair do PIO somado ao silêncio de latch
+static inline int64_t tempo_ate_latch_us(void)
+{
+    uint nivel = pio_sm_get_tx_fifo_level(matriz_pio, matriz_sm);
+    return (int64_t)(nivel + 1) * MATRIZ_US_POR_PIXEL + MATRIZ_RESET_US;
+}
+
+// Troca os quadros e dispara o DMA; chamar com a trava
+static void iniciar_transmissao(void)
+{
+    quadro_frente ^= 1;
+    quadro_pendente = false;
+    transmitindo = true;
+    dma_channel_transfer_from_buffer_now(canal_dma, quadros[quadro_frente], MATRIZ_NUM_PIXELS);
+}
+
+// Quadro terminado: libera a matriz e já envia o que ficou na fila
+static void terminar_transmissao(void)
+{
+    uint32_t irq = spin_lock_blocking(trava);
+    transmitindo = false;
+    if (quadro_pendente)
+    {
+        iniciar_transmissao();
+    }
+    spin_unlock(trava, irq);
+    if (matriz_callback)
+    {
+        matriz_callback(matriz_callback_arg);
+    }
+}
+
+static int64_t latch_alarm_cb(alarm_id_t id, void *user_data)
+{
+    // Ainda há pixels no FIFO: reagenda a partir de agora
+    if (!pio_sm_is_tx_fifo_empty(matriz_pio, matriz_sm))
+    {
+        return -tempo_ate_latch_us();
+    }
+    terminar_transmissao();
+    return 0;
+}
+
+static void matriz_dma_irq_handler(void)
+{
+    if (!dma_channel_get_irq1_status(canal_dma))
+    {
+        return; // IRQ compartilhada: não é o nosso canal
+    }
+    dma_channel_acknowledge_irq1(canal_dma);
+
+    // O DMA terminou de alimentar o FIFO; o latch é garantido por um alarme, sem sleep
+    if (add_alarm_in_us(tempo_ate_latch_us(), latch_alarm_cb, NULL, true) < 0)
+    {
+        // Sem alarmes livres: espera aqui o FIFO esvaziar e o latch (no máximo
+        // ~370 µs com o FIFO de 8 posições), para o próximo quadro não colar neste
+        busy_wait_us_32((uint32_t)tempo_ate_latch_us());
+        terminar_transmissao();
+    }
+}
+
+void init_matriz(PIO pio, uint sm)
+{
+    matriz_pio = pio;
+    matriz_sm = sm;
+    trava = spin_lock_instance(spin_lock_claim_unused(true));
+
+    canal_dma = dma_claim_unused_channel(true);
+    dma_channel_config c = dma_channel_get_default_config(canal_dma);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, pio_get_dreq(pio, sm, true));
+    dma_channel_configure(canal_dma, &c, &pio->txf[sm], NULL, MATRIZ_NUM_PIXELS, false);
+
+    // DMA_IRQ_1 fica livre para a aplicação; o driver CYW43 não a utiliza
+    dma_channel_set_irq1_enabled(canal_dma, true);
+    irq_add_shared_handler(DMA_IRQ_1, matriz_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+}
+
+void set_matriz_callback(matriz_callback_t callback, void *arg)
+{
+    matriz_callback = callback;
+    matriz_callback_arg = arg;
+}
+
+bool matriz_ocupada(void)
+{
+    return transmitindo || quadro_pendente;
+}
+
+void acender_matriz_janela(uint16_t abertura) {
     // Verifica se a abertura mudou desde a última chamada
     if (abertura == ultima_abertura) {
         return; // Não atualiza os LEDs se o valor de abertura não mudou
     }
     ultima_abertura = abertura;
 
-    int pixel_map[5][5] = {              // Mapeamento de índices da matriz WS2812
+    static const uint8_t pixel_map[5][5] = { // Mapeamento de índices da matriz WS2812
         {24, 23, 22, 21, 20},            // Linha 1: índices dos LEDs
         {15, 16, 17, 18, 19},            // Linha 2: índices dos LEDs
         {14, 13, 12, 11, 10},            // Linha 3: índices dos LEDs
         {5,  6,  7,  8,  9},             // Linha 4: índices dos LEDs
         {4,  3,  2,  1,  0}              // Linha 5: índices dos LEDs
     };
-    uint32_t pixels[25]; // Array para armazenar os valores RGB dos LEDs
+
+    // Retira o quadro de trás da fila antes de reescrevê-lo, para o alarme não enviá-lo pela metade
+    uint32_t irq = spin_lock_blocking(trava);
+    quadro_pendente = false;
+    spin_unlock(trava, irq);
+    uint32_t *pixels = quadros[quadro_frente ^ 1];
 
     // Zerar todos os LEDs para evitar lixo ou LEDs fantasmas
-    for (int i = 0; i < 25; i++) {
-        pixels[i] = urgb_u32(0, 0, 0); // Desliga todos os LEDs (RGB = 0, 0, 0)
+    for (int i = 0; i < MATRIZ_NUM_PIXELS; i++) {
+        pixels[i] = 0;
     }
 
     // Garante que a abertura esteja no intervalo de 0 a 100%
-    if (abertura < 0.0f) abertura = 0.0f;
-    if (abertura > 100.0f) abertura = 100.0f;
+    if (abertura > 10000) abertura = 10000;
 
     // Calcula a intensidade (0 a 255) proporcional à abertura
-    uint8_t intensidade = (uint8_t)((abertura * 255.0f) / 100.0f);
+    uint8_t intensidade = (uint8_t)((abertura * 255u) / 10000u);
 
     // Acende os 4 LEDs no canto superior direito com cor branca e intensidade proporcional
-    pixels[pixel_map[0][3]] = urgb_u32(intensidade, intensidade, intensidade); // LED [0][3] (índice 21)
-    pixels[pixel_map[0][4]] = urgb_u32(intensidade, intensidade, intensidade); // LED [0][4] (índice 20)
-    pixels[pixel_map[1][3]] = urgb_u32(intensidade, intensidade, intensidade); // LED [1][3] (índice 18)
-    pixels[pixel_map[1][4]] = urgb_u32(intensidade, intensidade, intensidade); // LED [1][4] (índice 19)
+    // (já deslocado para os 24 bits mais significativos, como o PIO espera)
+    uint32_t branco = urgb_u32(intensidade, intensidade, intensidade) << 8u;
+    pixels[pixel_map[0][3]] = branco; // LED [0][3] (índice 21)
+    pixels[pixel_map[0][4]] = branco; // LED [0][4] (índice 20)
+    pixels[pixel_map[1][3]] = branco; // LED [1][3] (índice 18)
+    pixels[pixel_map[1][4]] = branco; // LED [1][4] (índice 19)
 
-    // Envia os valores RGB para a matriz de LEDs
-    for (int i = 0; i < 25; i++) {
-        put_pixel(pixels[i]);
+    // Entrega o quadro ao DMA; se uma transmissão estiver em curso, ele sai após o latch
+    irq = spin_lock_blocking(trava);
+    quadro_pendente = true;
+    if (!transmitindo) {
+        iniciar_transmissao();
     }
-
-    // Adiciona um atraso para garantir que os WS2812 latcharem os dados corretamente
-    sleep_us(100); // 100µs de silêncio (mais que o mínimo de 50µs requerido)
-}
\ No newline at end of file
+    spin_unlock(trava, irq);
+}
@@ -1,6 +1,9 @@
-
 #include "generated/ws2812.pio.h" // programa PIO gerado para comunicação com a matriz WS2812
 
+// Chamada (em contexto de interrupção) quando um quadro termina de ser transmitido e travado
+typedef void (*matriz_callback_t)(void *arg);
 
-void acender_matriz_janela(float abertura);
-//
\ No newline at end of file
+void init_matriz(PIO pio, uint sm);
+void set_matriz_callback(matriz_callback_t callback, void *arg);
+bool matriz_ocupada(void);
+void acender_matriz_janela(uint16_t abertura); // Centésimos de porcento (0-10000)
@@ -0,0 +1,295 @@
+#include "nucleos.h"
+#include "hardware/structs/scb.h"
+#include "hardware/sync.h"
+#include <string.h>
+
+#if NUCLEOS_DUPLO
+#include "pico/cyw43_arch.h"
+#include "pico/multicore.h"
+#include "anel.h"
+#include "aplicacao.h"
+#include "ciclos.h"
+#include "hal.h"
+#endif
+
+static volatile uint32_t ocioso_us[NUM_CORES]; // Cada núcleo só escreve o seu
+static uint32_t ocioso_anterior[NUM_CORES];
+static uint64_t contadores_us;
+static NucleosContadores contadores;
+
+static int64_t acordar(alarm_id_t id, void *dados)
+{
+    __sev();
+    return 0;
+}
+
+void nucleos_dormir_ate(absolute_time_t ate)
+{
+    // O alarme roda no núcleo 0 e avisa qualquer um dos dois com __sev(); sem
+    // prazo, só uma interrupção ou um evento (eventos.h) acorda
+    alarm_id_t alarme = -1;
+    if (!is_at_the_end_of_time(ate))
+    {
+        alarme = add_alarm_at(ate, acordar, NULL, false);
+        if (alarme == 0)
+        {
+            return; // Já passou
+        }
+    }
+
+    // Com SEVONPEND toda interrupção que fica pendente acorda o __wfe(), mesmo
+    // mascarada; o handler só roda depois de medir, então o tempo dele conta
+    // como ocupado
+    scb_hw->scr |= M0PLUS_SCR_SEVONPEND_BITS; // Registro do próprio núcleo
+    uint32_t ints = save_and_disable_interrupts();
+    uint64_t inicio = time_us_64();
+    __wfe();
+    uint32_t parado = (uint32_t)(time_us_64() - inicio);
+    restore_interrupts(ints);
+    ocioso_us[get_core_num()] += parado;
+    if (alarme > 0)
+    {
+        cancel_alarm(alarme);
+    }
+}
+
+void nucleos_contadores(NucleosContadores *c)
+{
+    uint64_t agora = time_us_64();
+    uint32_t janela = (uint32_t)(agora - contadores_us);
+    contadores_us = agora;
+    for (uint i = 0; i < NUM_CORES; i++)
+    {
+        uint32_t ocioso = ocioso_us[i];
+        uint32_t parado = ocioso - ocioso_anterior[i];
+        ocioso_anterior[i] = ocioso;
+        contadores.uso[i] = (janela && parado < janela) ? (uint8_t)(100 - (uint64_t)parado * 100 / janela) : 0;
+    }
+#if !NUCLEOS_DUPLO
+    contadores.uso[1] = 0; // Núcleo 1 parado
+#endif
+    *c = contadores;
+}
+
+#if NUCLEOS_DUPLO
+
+typedef enum
+{
+    ENTRADA_MENSAGEM,   // Mensagem do broker
+    ENTRADA_CONECTADO,  // Conexão aceita, sem mensagem
+    ENTRADA_DESCARTADA, // Publicação descartada da fila de saída, só o tópico
+} TipoEntrada;
+
+typedef struct
+{
+    uint8_t tipo;
+    char topico[NUCLEOS_TOPICO_MAX];
+    char payload[NUCLEOS_PAYLOAD_MAX];
+} NucleosEntrada;
+
+typedef enum
+{
+    SAIDA_PUBLICAR, // Publicação para o cliente MQTT
+    SAIDA_ENCERRAR, // /exit, sem mensagem
+    SAIDA_LED,      // LED da placa, aceso se len != 0
+} TipoSaida;
+
+typedef struct
+{
+    uint8_t tipo;
+    bool retain;
+    uint8_t prioridade;
+    uint16_t len;
+    char topico[NUCLEOS_TOPICO_MAX];
+    uint8_t payload[NUCLEOS_PAYLOAD_MAX];
+} NucleosSaida;
+
+static NucleosEntrada itens_entrada[NUCLEOS_ANEL_ENTRADA];
+static NucleosSaida itens_saida[NUCLEOS_ANEL_SAIDA];
+static Anel anel_entrada; // Núcleo 0 -> núcleo 1
+static Anel anel_saida;   // Núcleo 1 -> núcleo 0
+
+static async_context_t *contexto_rede;
+static nucleos_publicar_t publicar_rede;
+static nucleos_tarefa_t encerrar_rede;
+static nucleos_tarefa_t iniciar_nucleo1;
+static nucleos_tarefa_t periodica_nucleo1;
+
+static void saida_worker_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static async_when_pending_worker_t saida_worker = {.do_work = saida_worker_fn};
+
+static inline void registrar_ocupacao(uint8_t *max, const Anel *a)
+{
+    uint32_t n = anel_ocupacao(a);
+    if (n > *max)
+    {
+        *max = (uint8_t)n;
+    }
+}
+
+// Núcleo 0, no contexto do lwIP: esvazia o anel de saída
+static void saida_worker_fn(async_context_t *context, async_when_pending_worker_t *worker)
+{
+    NucleosSaida *s;
+    while ((s = anel_frente(&anel_saida)))
+    {
+        if (s->tipo == SAIDA_ENCERRAR)
+        {
+            encerrar_rede();
+        }
+        else if (s->tipo == SAIDA_LED)
+        {
+            cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, s->len != 0);
+        }
+        else if (!publicar_rede(s->topico, s->payload, s->len, s->retain, s->prioridade))
+        {
+            contadores.saida_falhas++;
+        }
+        anel_liberar(&anel_saida);
+    }
+}
+
+// Núcleo 1: o lado de hal.h que fala com o núcleo 0
+bool hal_mqtt_publicar(const char *topico, const void *payload, uint16_t len, bool retain, SaidaPrioridade prioridade)
+{
+    NucleosSaida *s = anel_reservar(&anel_saida);
+    if (!s || len > sizeof(s->payload))
+    {
+        contadores.saida_recusadas++;
+        return false; // A camada de publicação tenta de novo no próximo ciclo
+    }
+    s->tipo = SAIDA_PUBLICAR;
+    s->retain = retain;
+    s->prioridade = prioridade;
+    s->len = len;
+    strncpy(s->topico, topico, sizeof(s->topico) - 1);
+    s->topico[sizeof(s->topico) - 1] = '\0';
+    memcpy(s->payload, payload, len);
+    anel_publicar(&anel_saida);
+    registrar_ocupacao(&contadores.saida_max, &anel_saida);
+    async_context_set_work_pending(contexto_rede, &saida_worker);
+    return true;
+}
+
+void hal_mqtt_encerrar(void)
+{
+    NucleosSaida *s = anel_reservar(&anel_saida);
+    if (s)
+    {
+        s->tipo = SAIDA_ENCERRAR;
+        anel_publicar(&anel_saida);
+        async_context_set_work_pending(contexto_rede, &saida_worker);
+    }
+}
+
+// O LED é um GPIO do CYW43: só o núcleo 0 fala com o chip, com a trava do
+// async_context; do núcleo 1 o pedido sobe pelo anel como uma publicação
+void hal_set_led(bool on)
+{
+    NucleosSaida *s = anel_reservar(&anel_saida);
+    if (!s)
+    {
+        contadores.saida_recusadas++;
+        return;
+    }
+    s->tipo = SAIDA_LED;
+    s->len = on;
+    anel_publicar(&anel_saida);
+    async_context_set_work_pending(contexto_rede, &saida_worker);
+}
+
+static bool enviar_entrada(TipoEntrada tipo, const char *topico, const char *payload)
+{
+    NucleosEntrada *e = anel_reservar(&anel_entrada);
+    if (!e)
+    {
+        contadores.entrada_perdidas++;
+        return false;
+    }
+    e->tipo = tipo;
+    if (topico)
+    {
+        strncpy(e->topico, topico, sizeof(e->topico) - 1);
+        e->topico[sizeof(e->topico) - 1] = '\0';
+    }
+    if (payload)
+    {
+        strncpy(e->payload, payload, sizeof(e->payload) - 1);
+        e->payload[sizeof(e->payload) - 1] = '\0';
+    }
+    anel_publicar(&anel_entrada);
+    registrar_ocupacao(&contadores.entrada_max, &anel_entrada);
+    __sev(); // Acorda o núcleo 1
+    return true;
+}
+
+bool nucleos_mensagem(const char *topico, const char *payload)
+{
+    return enviar_entrada(ENTRADA_MENSAGEM, topico, payload);
+}
+
+bool nucleos_conectado(void)
+{
+    return enviar_entrada(ENTRADA_CONECTADO, NULL, NULL);
+}
+
+// Perdido com o anel cheio, o tópico ainda sai no heartbeat da publicação
+bool nucleos_descartada(const char *topico)
+{
+    return enviar_entrada(ENTRADA_DESCARTADA, topico, NULL);
+}
+
+static void nucleo1_main(void)
+{
+    init_ciclos(); // SysTick do núcleo 1
+    iniciar_nucleo1();
+
+    // Os ciclos da aplicação começam com a conexão, como o worker do modo de um núcleo
+    absolute_time_t proximo_ciclo = at_the_end_of_time;
+    while (true)
+    {
+        NucleosEntrada *e;
+        while ((e = anel_frente(&anel_entrada)))
+        {
+            if (e->tipo == ENTRADA_CONECTADO)
+            {
+                aplicacao_conectado();
+                proximo_ciclo = get_absolute_time();
+            }
+            else if (e->tipo == ENTRADA_DESCARTADA)
+            {
+                aplicacao_descartada(e->topico);
+            }
+            else
+            {
+                aplicacao_mensagem(e->topico, e->payload);
+            }
+            anel_liberar(&anel_entrada);
+        }
+        if (time_reached(proximo_ciclo))
+        {
+            aplicacao_ciclo();
+            proximo_ciclo = delayed_by_ms(proximo_ciclo, NUCLEOS_CICLO_MS);
+        }
+        periodica_nucleo1();
+        nucleos_dormir_ate(proximo_ciclo);
+    }
+}
+
+void init_nucleos(async_context_t *contexto, nucleos_publicar_t publicar, nucleos_tarefa_t encerrar,
+                  nucleos_tarefa_t iniciar, nucleos_tarefa_t periodica)
+{
+    contexto_rede = contexto;
+    publicar_rede = publicar;
+    encerrar_rede = encerrar;
+    iniciar_nucleo1 = iniciar;
+    periodica_nucleo1 = periodica;
+    anel_init(&anel_entrada, itens_entrada, sizeof(NucleosEntrada), NUCLEOS_ANEL_ENTRADA);
+    anel_init(&anel_saida, itens_saida, sizeof(NucleosSaida), NUCLEOS_ANEL_SAIDA);
+    async_context_add_when_pending_worker(contexto, &saida_worker);
+
+    multicore_lockout_victim_init(); // O núcleo 1 grava a flash (calibracao.c)
+    multicore_launch_core1(nucleo1_main);
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef NUCLEOS_H
+#define NUCLEOS_H
+
+#include "pico/stdlib.h"
+
+// Modo de dois núcleos: o núcleo 0 fica com o Wi-Fi, o lwIP e o MQTT; o núcleo
+// 1 com a amostragem do ADC, a aplicação (comandos, automação e publicações) e
+// os atuadores (servo, relé, matriz). A fronteira é a de hal.h: as mensagens
+// recebidas descem por um anel e as publicações sobem por outro (anel.h), e
+// nenhum núcleo espera pelo outro. A FIFO entre os núcleos fica livre para o
+// bloqueio do núcleo 0 durante a gravação da flash (calibracao.c).
+#ifndef NUCLEOS_DUPLO
+#define NUCLEOS_DUPLO 0
+#endif
+
+#define NUCLEOS_ANEL_ENTRADA 8 // Mensagens do broker para o núcleo 1 (potência de 2)
+#define NUCLEOS_ANEL_SAIDA 16  // Publicações do núcleo 1 para o núcleo 0 (potência de 2)
+#define NUCLEOS_TOPICO_MAX 100 // MQTT_TOPIC_LEN
+#define NUCLEOS_PAYLOAD_MAX 256
+#define NUCLEOS_CICLO_MS 2000 // TEMP_WORKER_TIME_S
+
+typedef struct
+{
+    uint8_t uso[2];            // % do tempo ocupado de cada núcleo desde a leitura anterior
+    uint32_t entrada_perdidas; // Mensagens do broker descartadas com o anel de entrada cheio
+    uint32_t saida_recusadas;  // Publicações recusadas com o anel de saída cheio
+    uint32_t saida_falhas;     // Publicações recusadas pelo cliente MQTT no núcleo 0
+    uint8_t entrada_max;       // Maior ocupação de cada anel
+    uint8_t saida_max;
+} NucleosContadores;
+
+// Dorme até 'ate', até a próxima interrupção ou até um aviso do outro núcleo,
+// o que vier antes, somando o tempo parado ao ocioso do núcleo que chamou.
+// Com at_the_end_of_time não arma alarme: só interrupções e eventos acordam.
+void nucleos_dormir_ate(absolute_time_t ate);
+
+// Uso de cada núcleo desde a chamada anterior; chamar sempre do mesmo lugar
+void nucleos_contadores(NucleosContadores *c);
+
+#if NUCLEOS_DUPLO
+#include "pico/async_context.h"
+#include "saida.h"
+
+// Publica pelo cliente MQTT, no núcleo 0; devolve false se não conseguiu
+typedef bool (*nucleos_publicar_t)(const char *topico, const void *payload, uint16_t len, bool retain,
+                                   SaidaPrioridade prioridade);
+typedef void (*nucleos_tarefa_t)(void);
+
+// No núcleo 0, depois de cyw43_arch_init(). O núcleo 1 roda 'iniciar' (ADC,
+// sensores, atuadores, init_aplicacao()) e depois o laço da aplicação, com
+// 'periodica' a cada volta. As publicações saem por 'publicar' num worker do
+// 'contexto'; /exit chega ao núcleo 0 por 'encerrar'.
+void init_nucleos(async_context_t *contexto, nucleos_publicar_t publicar, nucleos_tarefa_t encerrar,
+                  nucleos_tarefa_t iniciar, nucleos_tarefa_t periodica);
+
+// Núcleo 0: entregam ao núcleo 1 sem esperar; false se o anel estiver cheio
+bool nucleos_mensagem(const char *topico, const char *payload);
+bool nucleos_conectado(void);
+bool nucleos_descartada(const char *topico); // A fila de saída descartou uma publicação do núcleo 1
+#endif
+
+#endif
@@ -0,0 +1,190 @@
+#include "painel.h"
+#include "ssd1306.h"
+#include "eventos.h"
+#include <stdio.h>
+#include <string.h>
+
+#define COMODOS_POR_PAGINA 2
+#define LINHAS_POR_COMODO 3
+
+// Último valor desenhado de cada campo; -1 força o redesenho
+typedef struct
+{
+    const Comodo *comodo;
+    int luz;
+    int janela;
+    int alvo;
+    int luz_ligada;
+    int modo;
+    bool selecionado;
+} CampoPainel;
+
+static ssd1306_t ssd;
+static Comodo *const *painel_comodos;
+static uint painel_num_comodos;
+static Comodo *const *painel_atual;
+static CampoPainel campos[COMODOS_POR_PAGINA];
+static uint pagina = 0;
+
+static EventosAssinante painel_eventos;
+
+// Redesenho quando o estado muda (eventos.h); os temporizadores só trocam a
+// página e refazem um envio que encontrou o I2C ocupado
+static void painel_desenho_fn(async_context_t *context, async_when_pending_worker_t *worker);
+static void painel_troca_fn(async_context_t *context, async_at_time_worker_t *worker);
+static void painel_retentativa_fn(async_context_t *context, async_at_time_worker_t *worker);
+static async_when_pending_worker_t painel_desenho = {.do_work = painel_desenho_fn};
+static async_at_time_worker_t painel_troca = {.do_work = painel_troca_fn};
+static async_at_time_worker_t painel_retentativa = {.do_work = painel_retentativa_fn};
+
+// Centésimos de porcento -> porcento inteiro
+static inline int arredonda(uint16_t centesimos)
+{
+    return (centesimos + 50) / 100;
+}
+
+static void esquecer_campo(CampoPainel *campo, const Comodo *comodo)
+{
+    campo->comodo = comodo;
+    campo->luz = campo->janela = campo->alvo = -1;
+    campo->luz_ligada = campo->modo = -1;
+    campo->selecionado = false;
+}
+
+// Desenha apenas os campos que mudaram desde o último quadro
+static void desenhar_comodo(uint slot, const Comodo *comodo)
+{
+    CampoPainel *campo = &campos[slot];
+    uint8_t y = slot * LINHAS_POR_COMODO * 8;
+    char texto[17];
+
+    if (comodo != campo->comodo)
+    {
+        ssd1306_rect(&ssd, y, 0, WIDTH, LINHAS_POR_COMODO * 8, false, true);
+        esquecer_campo(campo, comodo);
+        if (!comodo)
+            return;
+        snprintf(texto, sizeof(texto), "%-7.7s", comodo->nome);
+        ssd1306_draw_string(&ssd, texto, 8, y);
+    }
+    if (!comodo)
+        return;
+
+    bool selecionado = (comodo == *painel_atual);
+    if (selecionado != campo->selecionado)
+    {
+        campo->selecionado = selecionado;
+        ssd1306_draw_char(&ssd, selecionado ? '>' : ' ', 0, y);
+    }
+
+    int modo = comodo->modo_dormir ? 2 : comodo->modo_auto ? 1 : 0;
+    if (modo != campo->modo)
+    {
+        static const char *const nomes_modo[] = {"  MAN", " AUTO", "DORMIR"};
+        campo->modo = modo;
+        snprintf(texto, sizeof(texto), "%6s", nomes_modo[modo]);
+        ssd1306_draw_string(&ssd, texto, 72, y);
+    }
+
+    int luz = arredonda(comodo->luz);
+    if (luz != campo->luz)
+    {
+        campo->luz = luz;
+        snprintf(texto, sizeof(texto), "L%3d%%", luz);
+        ssd1306_draw_string(&ssd, texto, 0, y + 8);
+    }
+
+    int janela = arredonda(comodo->janela_pos);
+    if (janela != campo->janela)
+    {
+        campo->janela = janela;
+        snprintf(texto, sizeof(texto), "J%3d%%", janela);
+        ssd1306_draw_string(&ssd, texto, 64, y + 8);
+    }
+
+    int alvo = arredonda(comodo->iluminacao_alvo);
+    if (alvo != campo->alvo)
+    {
+        campo->alvo = alvo;
+        snprintf(texto, sizeof(texto), "A%3d%%", alvo);
+        ssd1306_draw_string(&ssd, texto, 0, y + 16);
+    }
+
+    if (comodo->luz_ligada != campo->luz_ligada)
+    {
+        campo->luz_ligada = comodo->luz_ligada;
+        ssd1306_draw_string(&ssd, comodo->luz_ligada ? "LUZ ON " : "LUZ OFF", 64, y + 16);
+    }
+}
+
+static void painel_desenho_fn(async_context_t *context, async_when_pending_worker_t *worker)
+{
+    eventos_retirar(&painel_eventos, NULL); // Os campos já detectam o que mudou
+
+    for (uint slot = 0; slot < COMODOS_POR_PAGINA; slot++)
+    {
+        uint indice = pagina * COMODOS_POR_PAGINA + slot;
+        desenhar_comodo(slot, indice < painel_num_comodos ? painel_comodos[indice] : NULL);
+    }
+
+    // O envio copia as janelas sujas para o buffer do DMA: o próximo quadro pode ser
+    // desenhado em ram_buffer enquanto o anterior ainda sai pelo I2C, sem rasgar a imagem.
+    // Se o envio anterior não terminou, as marcas de sujeira acumulam e o temporizador
+    // tenta de novo em PAINEL_PERIODO_MS.
+    if (ssd1306_busy(&ssd))
+    {
+        async_context_add_at_time_worker_in_ms(context, &painel_retentativa, PAINEL_PERIODO_MS);
+    }
+    else if (!ssd1306_send_data_async(&ssd, NULL, NULL))
+    {
+        ssd1306_send_data(&ssd); // Sem DMA disponível
+    }
+}
+
+static void painel_retentativa_fn(async_context_t *context, async_at_time_worker_t *worker)
+{
+    async_context_set_work_pending(context, &painel_desenho);
+}
+
+static void painel_troca_fn(async_context_t *context, async_at_time_worker_t *worker)
+{
+    // Com mais cômodos que cabem na tela, as páginas se alternam
+    uint paginas = (painel_num_comodos + COMODOS_POR_PAGINA - 1) / COMODOS_POR_PAGINA;
+    pagina = (pagina + 1) % paginas;
+    async_context_add_at_time_worker_in_ms(context, worker, PAINEL_TROCA_MS);
+    async_context_set_work_pending(context, &painel_desenho);
+}
+
+void init_painel(async_context_t *context, Comodo *const *comodos, uint num_comodos, Comodo *const *atual)
+{
+    painel_comodos = comodos;
+    painel_num_comodos = num_comodos;
+    painel_atual = atual;
+
+    i2c_init(PAINEL_I2C, 400 * 1000);
+    gpio_set_function(PAINEL_SDA_PIN, GPIO_FUNC_I2C);
+    gpio_set_function(PAINEL_SCL_PIN, GPIO_FUNC_I2C);
+    gpio_pull_up(PAINEL_SDA_PIN);
+    gpio_pull_up(PAINEL_SCL_PIN);
+
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, PAINEL_ENDERECO, PAINEL_I2C);
+    ssd1306_config(&ssd);
+    ssd1306_text_grid(&ssd, true);
+    ssd1306_fill(&ssd, false);
+    ssd1306_send_data(&ssd); // Envio bloqueante só durante o boot
+    if (!ssd1306_init_dma(&ssd))
+    {
+        printf("painel: sem canal DMA, usando I2C bloqueante\n");
+    }
+
+    for (uint i = 0; i < COMODOS_POR_PAGINA; i++)
+    {
+        esquecer_campo(&campos[i], NULL);
+    }
+    eventos_assinar(&painel_eventos, EVENTOS_ESTADO, context, &painel_desenho);
+    if (num_comodos > COMODOS_POR_PAGINA)
+    {
+        async_context_add_at_time_worker_in_ms(context, &painel_troca, PAINEL_TROCA_MS);
+    }
+    async_context_set_work_pending(context, &painel_desenho); // Primeiro quadro
+}
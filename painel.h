@@ -0,0 +1,20 @@
+#ifndef PAINEL_H
+#define PAINEL_H
+
+#include "pico/async_context.h"
+#include "hardware/i2c.h"
+#include "comodo.h"
+
+#define PAINEL_I2C i2c1
+#define PAINEL_SDA_PIN 14
+#define PAINEL_SCL_PIN 15
+#define PAINEL_ENDERECO 0x3C
+#define PAINEL_PERIODO_MS 250   // Nova tentativa quando o I2C ainda está ocupado
+#define PAINEL_TROCA_MS 4000    // Tempo de exibição de cada página de cômodos
+
+// Painel local no OLED: mostra o estado dos cômodos sem depender do broker.
+// 'atual' aponta para a variável que guarda o cômodo selecionado. Redesenha
+// quando a aplicação posta eventos de estado (eventos.h).
+void init_painel(async_context_t *context, Comodo *const *comodos, uint num_comodos, Comodo *const *atual);
+
+#endif
@@ -0,0 +1,125 @@
+#include "publicacao.h"
+#include <string.h>
+
+typedef struct
+{
+    uint32_t resumo;    // FNV-1a do último payload enviado
+    uint32_t topico;    // FNV-1a do tópico, para achar o slot de uma mensagem descartada
+    uint16_t tamanho;
+    bool valido;
+    uint64_t enviado_us;
+} SlotPublicacao;
+
+static SlotPublicacao slots[PUBLICACAO_MAX_SLOTS];
+static uint32_t campos_sujos[PUBLICACAO_MAX_GRUPOS];
+static publicacao_transporte_t transporte_atual;
+static void *contexto_atual;
+static uint64_t heartbeat_us = PUBLICACAO_HEARTBEAT_MS * 1000ull;
+static PublicacaoContadores contadores = {0};
+
+// Um resumo de 32 bits basta: uma colisão só atrasa a atualização até o heartbeat
+static uint32_t resumir(const uint8_t *p, size_t n)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < n; i++)
+    {
+        h = (h ^ p[i]) * 16777619u;
+    }
+    return h;
+}
+
+void init_publicacao(publicacao_transporte_t transporte, void *contexto, uint32_t heartbeat_ms)
+{
+    transporte_atual = transporte;
+    contexto_atual = contexto;
+    publicacao_set_heartbeat(heartbeat_ms);
+    publicacao_esquecer();
+}
+
+void publicacao_set_heartbeat(uint32_t heartbeat_ms)
+{
+    heartbeat_us = (uint64_t)heartbeat_ms * 1000u;
+}
+
+void publicacao_marcar(uint grupo, uint32_t campos)
+{
+    if (grupo < PUBLICACAO_MAX_GRUPOS)
+    {
+        campos_sujos[grupo] |= campos;
+    }
+}
+
+uint32_t publicacao_pendentes(uint grupo)
+{
+    if (grupo >= PUBLICACAO_MAX_GRUPOS)
+    {
+        return 0;
+    }
+    uint32_t campos = campos_sujos[grupo];
+    campos_sujos[grupo] = 0;
+    return campos;
+}
+
+bool publicacao_publicar(uint slot, const char *topico, const char *payload, bool retain)
+{
+    return publicacao_publicar_bytes(slot, topico, payload, (uint16_t)strlen(payload), retain);
+}
+
+bool publicacao_publicar_bytes(uint slot, const char *topico, const void *payload, uint16_t n, bool retain)
+{
+    if (slot >= PUBLICACAO_MAX_SLOTS || !transporte_atual)
+    {
+        return false;
+    }
+    SlotPublicacao *s = &slots[slot];
+    uint32_t resumo = resumir(payload, n);
+    uint64_t agora = time_us_64();
+
+    if (s->valido && s->resumo == resumo && s->tamanho == n && agora - s->enviado_us < heartbeat_us)
+    {
+        contadores.suprimidas++;
+        return false;
+    }
+    if (!transporte_atual(contexto_atual, slot, topico, payload, n, retain))
+    {
+        contadores.falhas++;
+        return false;
+    }
+    contadores.enviadas++;
+    s->resumo = resumo;
+    s->topico = resumir((const uint8_t *)topico, strlen(topico));
+    s->tamanho = n;
+    s->valido = true;
+    s->enviado_us = agora;
+    return true;
+}
+
+void publicacao_esquecer(void)
+{
+    for (uint i = 0; i < PUBLICACAO_MAX_SLOTS; i++)
+    {
+        slots[i].valido = false;
+    }
+}
+
+// Só roda quando a fila de saída descarta algo, então a busca linear basta; uma
+// colisão de resumo reenvia um slot a mais e deixa o outro para o heartbeat
+bool publicacao_invalidar(const char *topico, uint *slot)
+{
+    uint32_t resumo = resumir((const uint8_t *)topico, strlen(topico));
+    for (uint i = 0; i < PUBLICACAO_MAX_SLOTS; i++)
+    {
+        if (slots[i].valido && slots[i].topico == resumo)
+        {
+            slots[i].valido = false;
+            *slot = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+void publicacao_contadores(PublicacaoContadores *c)
+{
+    *c = contadores;
+}
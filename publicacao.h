@@ -0,0 +1,44 @@
+#ifndef PUBLICACAO_H
+#define PUBLICACAO_H
+
+#include "pico/stdlib.h"
+
+#define PUBLICACAO_MAX_SLOTS 112      // Tópicos distintos acompanhados
+#define PUBLICACAO_MAX_GRUPOS 16      // Grupos de campos sujos (um por cômodo)
+#define PUBLICACAO_HEARTBEAT_MS 30000 // Reenvio de estado retido que não mudou
+
+// Envia a mensagem do 'slot'; devolve false se não foi possível (ela é tentada de novo depois)
+typedef bool (*publicacao_transporte_t)(void *contexto, uint slot, const char *topico, const void *payload, uint16_t len,
+                                        bool retain);
+
+typedef struct
+{
+    uint32_t enviadas;
+    uint32_t suprimidas; // Payload igual ao último enviado, dentro do heartbeat
+    uint32_t falhas;     // Recusadas pelo transporte
+} PublicacaoContadores;
+
+// Camada de publicação com detecção de mudança: cada tópico ocupa um slot que
+// guarda um resumo do último payload enviado. Quem altera o estado só marca os
+// campos sujos; no fim do ciclo o dono do estado percorre os pendentes e
+// publica cada tópico uma vez, com o valor mais recente.
+void init_publicacao(publicacao_transporte_t transporte, void *contexto, uint32_t heartbeat_ms);
+void publicacao_set_heartbeat(uint32_t heartbeat_ms);
+
+void publicacao_marcar(uint grupo, uint32_t campos);
+uint32_t publicacao_pendentes(uint grupo); // Devolve e limpa os campos marcados
+
+// Publica se o payload mudou ou o heartbeat venceu; devolve true se enviou
+bool publicacao_publicar(uint slot, const char *topico, const char *payload, bool retain);
+bool publicacao_publicar_bytes(uint slot, const char *topico, const void *payload, uint16_t len, bool retain);
+
+// Esquece o que foi enviado (ex.: nova conexão ao broker), forçando o reenvio
+void publicacao_esquecer(void);
+
+// O transporte aceitou a mensagem do tópico mas ela não chegou a sair (ex.:
+// descartada da fila de saída): o slot publica de novo mesmo sem mudança.
+// Devolve false se nenhum slot enviou esse tópico
+bool publicacao_invalidar(const char *topico, uint *slot);
+void publicacao_contadores(PublicacaoContadores *contadores);
+
+#endif
@@ -0,0 +1,168 @@
+#include "rotas.h"
+#include <string.h>
+
+#define ROTAS_PREFIXO "/casa/"
+#define ROTAS_MAX_SEMENTES 1024
+
+typedef struct
+{
+    uint32_t semente;
+    uint8_t max_sondagem; // 1 quando a semente encontrada é perfeita
+    const char *chaves[ROTAS_TAM_TABELA];
+    uint8_t tamanhos[ROTAS_TAM_TABELA];
+    const void *valores[ROTAS_TAM_TABELA];
+} TabelaHash;
+
+static TabelaHash tabela_comodos;
+static TabelaHash tabela_rotas_comodo;
+static TabelaHash tabela_rotas_globais;
+
+// FNV-1a sobre um segmento (não precisa terminar em '\0')
+static inline uint32_t hash_segmento(const char *s, size_t n, uint32_t semente)
+{
+    uint32_t h = 2166136261u ^ semente;
+    for (size_t i = 0; i < n; i++)
+    {
+        h = (h ^ (uint8_t)s[i]) * 16777619u;
+    }
+    return h;
+}
+
+static bool montar_com_semente(TabelaHash *t, const char *const *chaves, const void *const *valores, uint n, uint32_t semente)
+{
+    memset(t, 0, sizeof(*t));
+    t->semente = semente;
+    for (uint i = 0; i < n; i++)
+    {
+        size_t tam = strlen(chaves[i]);
+        uint32_t pos = hash_segmento(chaves[i], tam, semente);
+        uint sondagem = 1;
+        while (t->chaves[pos & (ROTAS_TAM_TABELA - 1)])
+        {
+            if (t->tamanhos[pos & (ROTAS_TAM_TABELA - 1)] == tam && memcmp(t->chaves[pos & (ROTAS_TAM_TABELA - 1)], chaves[i], tam) == 0)
+            {
+                return false; // Chave duplicada
+            }
+            pos++;
+            sondagem++;
+        }
+        pos &= ROTAS_TAM_TABELA - 1;
+        t->chaves[pos] = chaves[i];
+        t->tamanhos[pos] = (uint8_t)tam;
+        t->valores[pos] = valores[i];
+        if (sondagem > t->max_sondagem)
+        {
+            t->max_sondagem = sondagem;
+        }
+    }
+    return true;
+}
+
+// Procura a semente com a menor sondagem máxima; para na primeira perfeita
+static bool montar_tabela(TabelaHash *t, const char *const *chaves, const void *const *valores, uint n)
+{
+    if (n > ROTAS_MAX_CHAVES)
+    {
+        return false;
+    }
+    uint32_t melhor_semente = 0;
+    uint melhor_sondagem = UINT8_MAX;
+    for (uint32_t semente = 0; semente < ROTAS_MAX_SEMENTES && melhor_sondagem > 1; semente++)
+    {
+        if (!montar_com_semente(t, chaves, valores, n, semente))
+        {
+            return false;
+        }
+        if (t->max_sondagem < melhor_sondagem)
+        {
+            melhor_sondagem = t->max_sondagem;
+            melhor_semente = semente;
+        }
+    }
+    return montar_com_semente(t, chaves, valores, n, melhor_semente);
+}
+
+static const void *buscar(const TabelaHash *t, const char *s, size_t n)
+{
+    uint32_t pos = hash_segmento(s, n, t->semente);
+    for (uint i = 0; i < t->max_sondagem; i++, pos++)
+    {
+        uint indice = pos & (ROTAS_TAM_TABELA - 1);
+        const char *chave = t->chaves[indice];
+        if (!chave)
+        {
+            return NULL;
+        }
+        if (t->tamanhos[indice] == n && memcmp(chave, s, n) == 0)
+        {
+            return t->valores[indice];
+        }
+    }
+    return NULL;
+}
+
+static bool montar_rotas(TabelaHash *t, const Rota *rotas, uint n)
+{
+    const char *chaves[ROTAS_MAX_CHAVES];
+    const void *valores[ROTAS_MAX_CHAVES];
+    if (n > ROTAS_MAX_CHAVES)
+    {
+        return false;
+    }
+    for (uint i = 0; i < n; i++)
+    {
+        chaves[i] = rotas[i].caminho;
+        valores[i] = &rotas[i];
+    }
+    return montar_tabela(t, chaves, valores, n);
+}
+
+bool init_rotas(Comodo *const *comodos, uint n_comodos,
+                const Rota *rotas_comodo, uint n_rotas_comodo,
+                const Rota *rotas_globais, uint n_rotas_globais)
+{
+    const char *nomes[ROTAS_MAX_CHAVES];
+    const void *valores[ROTAS_MAX_CHAVES];
+    if (n_comodos > ROTAS_MAX_CHAVES)
+    {
+        return false;
+    }
+    for (uint i = 0; i < n_comodos; i++)
+    {
+        nomes[i] = comodos[i]->nome;
+        valores[i] = comodos[i];
+    }
+    return montar_tabela(&tabela_comodos, nomes, valores, n_comodos) &&
+           montar_rotas(&tabela_rotas_comodo, rotas_comodo, n_rotas_comodo) &&
+           montar_rotas(&tabela_rotas_globais, rotas_globais, n_rotas_globais);
+}
+
+bool rotas_despachar(void *contexto, const char *topico, const char *payload)
+{
+    const size_t tam_prefixo = sizeof(ROTAS_PREFIXO) - 1;
+    if (strncmp(topico, ROTAS_PREFIXO, tam_prefixo) == 0)
+    {
+        const char *nome = topico + tam_prefixo;
+        const char *barra = strchr(nome, '/');
+        if (barra)
+        {
+            // Nome inteiro do cômodo: "salao" não cai em "sala"
+            Comodo *comodo = (Comodo *)buscar(&tabela_comodos, nome, barra - nome);
+            const char *caminho = barra + 1;
+            const Rota *rota = comodo ? buscar(&tabela_rotas_comodo, caminho, strlen(caminho)) : NULL;
+            if (rota)
+            {
+                rota->handler(contexto, comodo, topico, payload);
+                return true;
+            }
+        }
+    }
+
+    const Rota *rota = buscar(&tabela_rotas_globais, topico, strlen(topico));
+    if (rota)
+    {
+        rota->handler(contexto, NULL, topico, payload);
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,30 @@
+#ifndef ROTAS_H
+#define ROTAS_H
+
+#include "pico/stdlib.h"
+#include "comodo.h"
+
+#define ROTAS_TAM_TABELA 32 // Potência de 2, ao menos o dobro de chaves por tabela
+#define ROTAS_MAX_CHAVES (ROTAS_TAM_TABELA / 2)
+
+// 'comodo' é NULL nas rotas globais; 'topico' é o tópico completo, para log/eco
+typedef void (*rota_handler_t)(void *contexto, Comodo *comodo, const char *topico, const char *payload);
+
+typedef struct
+{
+    const char *caminho; // Ex.: "janela/set" (rota de cômodo) ou "/casa/select" (global)
+    rota_handler_t handler;
+} Rota;
+
+// Roteador de tópicos: "/casa/<comodo>/<caminho>" é dividido uma única vez e
+// cada segmento resolvido numa tabela de hash montada no início. A semente do
+// hash é escolhida para não haver colisões, então cada busca custa um hash e
+// uma comparação, independente do número de tópicos e cômodos.
+bool init_rotas(Comodo *const *comodos, uint n_comodos,
+                const Rota *rotas_comodo, uint n_rotas_comodo,
+                const Rota *rotas_globais, uint n_rotas_globais);
+
+// Devolve false se nenhuma rota atende o tópico
+bool rotas_despachar(void *contexto, const char *topico, const char *payload);
+
+#endif
@@ -0,0 +1,235 @@
+#include "saida.h"
+#include <string.h>
+
+#define SAIDA_NENHUM 0xFF
+_Static_assert(SAIDA_MAX_ITENS < SAIDA_NENHUM, "SAIDA_MAX_ITENS grande demais para o índice");
+
+typedef struct
+{
+    uint8_t proximo;
+    bool retain;
+    uint16_t len;
+    uint32_t resumo; // Do tópico, para achar a mensagem a mesclar sem strcmp em todas
+    char topico[SAIDA_TOPICO_MAX];
+    uint8_t payload[SAIDA_PAYLOAD_MAX];
+} ItemSaida;
+
+// Uma lista encadeada por prioridade (ordem de chegada) e uma de itens livres
+typedef struct
+{
+    uint8_t inicio;
+    uint8_t fim;
+} ListaSaida;
+
+static ItemSaida itens[SAIDA_MAX_ITENS];
+static ListaSaida filas[SAIDA_NUM_PRIORIDADES];
+static uint8_t livres;
+static saida_envio_t envio_atual;
+static saida_descarte_t descarte_atual;
+static void *contexto_atual;
+static SaidaContadores contadores = {0};
+
+static uint32_t resumir(const char *s)
+{
+    uint32_t h = 2166136261u;
+    while (*s)
+    {
+        h = (h ^ (uint8_t)*s++) * 16777619u;
+    }
+    return h;
+}
+
+static void lista_inserir(ListaSaida *l, uint8_t i)
+{
+    itens[i].proximo = SAIDA_NENHUM;
+    if (l->fim == SAIDA_NENHUM)
+    {
+        l->inicio = i;
+    }
+    else
+    {
+        itens[l->fim].proximo = i;
+    }
+    l->fim = i;
+}
+
+static void lista_remover(ListaSaida *l, uint8_t anterior, uint8_t i)
+{
+    if (anterior == SAIDA_NENHUM)
+    {
+        l->inicio = itens[i].proximo;
+    }
+    else
+    {
+        itens[anterior].proximo = itens[i].proximo;
+    }
+    if (l->fim == i)
+    {
+        l->fim = anterior;
+    }
+}
+
+static void liberar(uint8_t i)
+{
+    itens[i].proximo = livres;
+    livres = i;
+    contadores.profundidade--;
+}
+
+// Item na fila com o mesmo tópico; 'anterior' permite tirá-lo da lista
+static bool procurar(const char *topico, uint32_t resumo, uint *prioridade, uint8_t *anterior, uint8_t *item)
+{
+    for (uint p = 0; p < SAIDA_NUM_PRIORIDADES; p++)
+    {
+        uint8_t ant = SAIDA_NENHUM;
+        for (uint8_t i = filas[p].inicio; i != SAIDA_NENHUM; ant = i, i = itens[i].proximo)
+        {
+            if (itens[i].resumo == resumo && strcmp(itens[i].topico, topico) == 0)
+            {
+                *prioridade = p;
+                *anterior = ant;
+                *item = i;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Fila cheia: o item mais novo de prioridade menor que 'prioridade' abre espaço
+static bool descartar_menos_importante(uint prioridade)
+{
+    for (uint p = SAIDA_NUM_PRIORIDADES - 1; p > prioridade; p--)
+    {
+        uint8_t i = filas[p].fim;
+        if (i == SAIDA_NENHUM)
+        {
+            continue;
+        }
+        uint8_t ant = SAIDA_NENHUM;
+        for (uint8_t j = filas[p].inicio; j != i; j = itens[j].proximo)
+        {
+            ant = j;
+        }
+        lista_remover(&filas[p], ant, i);
+        if (descarte_atual)
+        {
+            descarte_atual(contexto_atual, itens[i].topico);
+        }
+        liberar(i);
+        contadores.descartadas++;
+        return true;
+    }
+    return false;
+}
+
+static void drenar(void)
+{
+    for (uint p = 0; p < SAIDA_NUM_PRIORIDADES && contadores.em_voo < SAIDA_EM_VOO; p++)
+    {
+        while (filas[p].inicio != SAIDA_NENHUM && contadores.em_voo < SAIDA_EM_VOO)
+        {
+            uint8_t i = filas[p].inicio;
+            ItemSaida *item = &itens[i];
+            if (!envio_atual(contexto_atual, item->topico, item->payload, item->len, item->retain))
+            {
+                // Sem memória ou sem conexão: espera a próxima conclusão ou mensagem
+                contadores.adiadas++;
+                return;
+            }
+            contadores.em_voo++;
+            contadores.enviadas++;
+            lista_remover(&filas[p], SAIDA_NENHUM, i);
+            liberar(i);
+        }
+    }
+}
+
+void init_saida(saida_envio_t envio, saida_descarte_t descarte, void *contexto)
+{
+    envio_atual = envio;
+    descarte_atual = descarte;
+    contexto_atual = contexto;
+    for (uint p = 0; p < SAIDA_NUM_PRIORIDADES; p++)
+    {
+        filas[p].inicio = filas[p].fim = SAIDA_NENHUM;
+    }
+    livres = SAIDA_NENHUM;
+    for (uint i = 0; i < SAIDA_MAX_ITENS; i++)
+    {
+        itens[i].proximo = livres;
+        livres = (uint8_t)i;
+    }
+}
+
+bool saida_enfileirar(const char *topico, const void *payload, uint16_t len, bool retain, SaidaPrioridade prioridade)
+{
+    if (len > SAIDA_PAYLOAD_MAX || strlen(topico) >= SAIDA_TOPICO_MAX || prioridade >= SAIDA_NUM_PRIORIDADES)
+    {
+        contadores.descartadas++;
+        return false;
+    }
+
+    uint32_t resumo = resumir(topico);
+    uint p_antiga;
+    uint8_t anterior, i;
+    if (procurar(topico, resumo, &p_antiga, &anterior, &i))
+    {
+        // O valor novo ocupa o lugar do antigo; com prioridade maior, vai para o fim da fila dela
+        contadores.mescladas++;
+        if (prioridade < p_antiga)
+        {
+            lista_remover(&filas[p_antiga], anterior, i);
+            lista_inserir(&filas[prioridade], i);
+        }
+    }
+    else
+    {
+        if (livres == SAIDA_NENHUM && !descartar_menos_importante(prioridade))
+        {
+            contadores.descartadas++;
+            return false;
+        }
+        i = livres;
+        livres = itens[i].proximo;
+        if (++contadores.profundidade > contadores.profundidade_max)
+        {
+            contadores.profundidade_max = contadores.profundidade;
+        }
+        strcpy(itens[i].topico, topico);
+        itens[i].resumo = resumo;
+        lista_inserir(&filas[prioridade], i);
+    }
+
+    ItemSaida *item = &itens[i];
+    item->retain = retain;
+    item->len = len;
+    memcpy(item->payload, payload, len);
+    drenar();
+    return true;
+}
+
+void saida_concluida(bool ok)
+{
+    if (contadores.em_voo > 0)
+    {
+        contadores.em_voo--;
+    }
+    if (!ok)
+    {
+        contadores.falhas++;
+    }
+    drenar();
+}
+
+void saida_reiniciar(void)
+{
+    contadores.em_voo = 0;
+    drenar();
+}
+
+void saida_contadores(SaidaContadores *c)
+{
+    *c = contadores;
+    contadores.profundidade_max = contadores.profundidade;
+}
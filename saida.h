@@ -0,0 +1,57 @@
+#ifndef SAIDA_H
+#define SAIDA_H
+
+#include "pico/stdlib.h"
+
+#ifndef SAIDA_MAX_ITENS
+#define SAIDA_MAX_ITENS 24 // Mensagens esperando a vez (memória estática)
+#endif
+#ifndef SAIDA_EM_VOO
+#define SAIDA_EM_VOO 8 // Publicações no lwIP ao mesmo tempo (MQTT_REQ_MAX_IN_FLIGHT é 30)
+#endif
+#define SAIDA_TOPICO_MAX 100
+#define SAIDA_PAYLOAD_MAX 256
+
+// Prioridade de cada mensagem: a fila entrega as respostas primeiro e, cheia,
+// descarta da telemetria para abrir espaço
+typedef enum
+{
+    SAIDA_RESPOSTA,   // Confirmações de comandos (/led/state, /uptime, calibração...)
+    SAIDA_ESTADO,     // Estado dos cômodos
+    SAIDA_TELEMETRIA, // Medidas periódicas (luz, temperatura, horário)
+    SAIDA_NUM_PRIORIDADES
+} SaidaPrioridade;
+
+// Entrega uma mensagem ao cliente MQTT; false se ele não a aceitou agora
+typedef bool (*saida_envio_t)(void *contexto, const char *topico, const void *payload, uint16_t len, bool retain);
+// Uma mensagem já aceita saiu da fila sem ser enviada, para abrir espaço a uma
+// mais importante; não pode enfileirar nada de dentro do aviso
+typedef void (*saida_descarte_t)(void *contexto, const char *topico);
+
+typedef struct
+{
+    uint16_t profundidade; // Na fila agora
+    uint16_t profundidade_max;
+    uint16_t em_voo;
+    uint32_t enviadas;
+    uint32_t mescladas;   // Substituíram um valor ainda na fila para o mesmo tópico
+    uint32_t descartadas; // Fila cheia ou mensagem grande demais
+    uint32_t adiadas;     // Recusadas pelo cliente; ficam na fila para depois
+    uint32_t falhas;      // Concluídas com erro (ex.: sem PUBACK)
+} SaidaContadores;
+
+// Fila de saída do MQTT: o cliente lwIP só recebe SAIDA_EM_VOO publicações por
+// vez e a próxima sai quando uma termina (saida_concluida, no callback da
+// requisição). Uma mensagem para um tópico que já está na fila substitui o
+// valor antigo no lugar dele. Cheia, a fila descarta a mensagem mais nova de
+// prioridade menor e avisa 'descarte' (pode ser NULL), para que quem a gerou a
+// publique de novo. Tudo no contexto do lwIP, sem travas.
+void init_saida(saida_envio_t envio, saida_descarte_t descarte, void *contexto);
+
+// Devolve false se a mensagem foi descartada
+bool saida_enfileirar(const char *topico, const void *payload, uint16_t len, bool retain, SaidaPrioridade prioridade);
+void saida_concluida(bool ok);
+void saida_reiniciar(void); // Conexão nova: as requisições antigas não voltam mais
+void saida_contadores(SaidaContadores *c); // Zera o máximo de profundidade
+
+#endif
@@ -0,0 +1,177 @@
+#include "sensores.h"
+#include "aquisicao.h"
+#include "filtro.h"
+#include "calibracao.h"
+
+static SensoresSnapshot snapshot = {0};
+static uint8_t luz_valida = 0; // Bit i: snapshot.luz[i] já foi lida
+static bool temperatura_valida = false;
+static uint32_t idade_max_luz_us = SENSORES_IDADE_MAX_LUZ_MS * 1000u;
+static uint32_t idade_max_temperatura_us = SENSORES_IDADE_MAX_TEMP_MS * 1000u;
+static SensoresContadores contadores = {0};
+
+// Uma cadeia de filtros por LDR, cada uma alimentada pela sua fatia do round-robin
+static Filtro filtro_ldr[SENSORES_NUM_LDR];
+static volatile int32_t ldr_filtrado[SENSORES_NUM_LDR] = {-1, -1, -1}; // -1 até a primeira saída
+
+static inline void processar_ldr(uint entrada, const uint16_t *amostras, uint n, uint passo)
+{
+    Filtro *f = &filtro_ldr[entrada];
+    for (uint i = 0; i < n; i++, amostras += passo)
+    {
+        if (filtro_amostra(f, *amostras))
+        {
+            ldr_filtrado[entrada] = filtro_saida(f);
+        }
+    }
+}
+
+static void processar_ldr0(const uint16_t *amostras, uint n, uint passo)
+{
+    processar_ldr(0, amostras, n, passo);
+}
+
+static void processar_ldr1(const uint16_t *amostras, uint n, uint passo)
+{
+    processar_ldr(1, amostras, n, passo);
+}
+
+static void processar_ldr2(const uint16_t *amostras, uint n, uint passo)
+{
+    processar_ldr(2, amostras, n, passo);
+}
+
+static const aquisicao_processador_t processadores_ldr[SENSORES_NUM_LDR] = {processar_ldr0, processar_ldr1, processar_ldr2};
+
+void init_sensores(void)
+{
+    init_calibracao();
+
+    uint8_t entradas = aquisicao_entradas();
+    for (uint i = 0; i < SENSORES_NUM_LDR; i++)
+    {
+        if (!(SENSORES_ENTRADAS_LDR & entradas & (1u << i)))
+        {
+            continue;
+        }
+        filtro_init(&filtro_ldr[i]);
+        filtro_config_mediana(&filtro_ldr[i], SENSORES_MEDIANA);
+        filtro_config_notch(&filtro_ldr[i], 2 * SENSORES_FREQ_REDE_HZ, aquisicao_taxa(), 0.95f);
+        filtro_config_sobreamostragem(&filtro_ldr[i], SENSORES_BITS_EXTRA);
+        filtro_config_passa_baixa(&filtro_ldr[i], SENSORES_PASSA_BAIXA_K);
+        aquisicao_set_processador(i, processadores_ldr[i]);
+    }
+}
+
+static float read_onboard_temperature(const char unit)
+{
+    // O sensor interno entra no round-robin; fora dele, uma conversão avulsa
+    uint16_t bruto = (aquisicao_entradas() & (1u << AQUISICAO_ENTRADA_TEMPERATURA))
+                         ? aquisicao_media(AQUISICAO_ENTRADA_TEMPERATURA)
+                         : aquisicao_ler_unica(AQUISICAO_ENTRADA_TEMPERATURA);
+    const float conversionFactor = 3.3f / (1 << 12);
+    float adc = (float)bruto * conversionFactor;
+    float tempC = 27.0f - (adc - 0.706f) / 0.001721f;
+
+    if (unit == 'C' || unit != 'F')
+    {
+        return tempC;
+    }
+    else if (unit == 'F')
+    {
+        return tempC * 9 / 5 + 32;
+    }
+
+    return -1.0f;
+}
+
+uint16_t sensores_ldr_bruto(uint entrada)
+{
+    // Saída da cadeia de filtros; até ela existir, a média simples da janela do DMA
+    int32_t filtrado = ldr_filtrado[entrada];
+    return (filtrado >= 0) ? (uint16_t)filtrado : (uint16_t)(aquisicao_media(entrada) << SENSORES_BITS_EXTRA);
+}
+
+static uint16_t read_ldr(uint entrada)
+{
+    // Tabela calibrada do sensor, em centésimos de porcento
+    return calibracao_converter(entrada, sensores_ldr_bruto(entrada));
+}
+
+// Média dos LDRs pedidos; 'forcar' ignora o cache
+static uint16_t luz_entradas(uint8_t entradas, bool forcar)
+{
+    entradas &= SENSORES_ENTRADAS_LDR & aquisicao_entradas();
+    if (!entradas)
+    {
+        entradas = SENSORES_ENTRADAS_LDR;
+    }
+
+    uint64_t agora = time_us_64();
+    uint32_t soma = 0;
+    uint n = 0;
+    for (uint i = 0; i < SENSORES_NUM_LDR; i++)
+    {
+        if (!(entradas & (1u << i)))
+        {
+            continue;
+        }
+        if (!forcar && (luz_valida & (1u << i)) && agora - snapshot.luz_us[i] <= idade_max_luz_us)
+        {
+            contadores.acertos++;
+        }
+        else
+        {
+            contadores.falhas++;
+            snapshot.luz[i] = read_ldr(i);
+            snapshot.luz_us[i] = agora;
+            luz_valida |= 1u << i;
+        }
+        soma += snapshot.luz[i];
+        n++;
+    }
+    return n ? (soma + n / 2) / n : 0;
+}
+
+uint16_t sensores_luz(uint8_t entradas)
+{
+    return luz_entradas(entradas, false);
+}
+
+uint16_t sensores_luz_atualizada(uint8_t entradas)
+{
+    return luz_entradas(entradas, true);
+}
+
+float sensores_temperatura(void)
+{
+    uint64_t agora = time_us_64();
+    if (temperatura_valida && agora - snapshot.temperatura_us <= idade_max_temperatura_us)
+    {
+        contadores.acertos++;
+        return snapshot.temperatura;
+    }
+    contadores.falhas++;
+    snapshot.temperatura = read_onboard_temperature(TEMPERATURE_UNITS);
+    snapshot.temperatura_us = agora;
+    temperatura_valida = true;
+    return snapshot.temperatura;
+}
+
+void sensores_snapshot(SensoresSnapshot *s)
+{
+    sensores_luz(SENSORES_ENTRADAS_LDR);
+    sensores_temperatura();
+    *s = snapshot;
+}
+
+void sensores_set_idade_max(uint32_t luz_ms, uint32_t temperatura_ms)
+{
+    idade_max_luz_us = luz_ms * 1000u;
+    idade_max_temperatura_us = temperatura_ms * 1000u;
+}
+
+void sensores_contadores(SensoresContadores *c)
+{
+    *c = contadores;
+}
@@ -0,0 +1,60 @@
+#ifndef SENSORES_H
+#define SENSORES_H
+
+#include "pico/stdlib.h"
+
+#ifndef TEMPERATURE_UNITS
+#define TEMPERATURE_UNITS 'C'
+#endif
+
+#define SENSORES_IDADE_MAX_LUZ_MS 1000 // Leituras de luz mais velhas que isso são refeitas
+#define SENSORES_IDADE_MAX_TEMP_MS 5000
+
+// Entradas do ADC com LDR (bit i = ADC i, GPIO 26 + i). Na BitDogLab os GPIOs
+// 26/27 são do joystick, então o padrão é só o LDR do GPIO 28.
+#define SENSORES_NUM_LDR 3
+#ifndef SENSORES_ENTRADAS_LDR
+#define SENSORES_ENTRADAS_LDR (1u << 2)
+#endif
+
+// Filtro do LDR (ver filtro.h)
+#define SENSORES_FREQ_REDE_HZ 60      // Lâmpadas cintilam no dobro da frequência da rede
+#define SENSORES_MEDIANA 5
+#define SENSORES_BITS_EXTRA 2         // Sobreamostragem 16x: 14 bits efetivos
+#define SENSORES_PASSA_BAIXA_K 2
+
+// Última leitura de cada sensor com o instante em que foi feita
+typedef struct
+{
+    uint16_t luz[SENSORES_NUM_LDR];     // Centésimos de %, por entrada do ADC
+    float temperatura;                  // Em TEMPERATURE_UNITS
+    uint64_t luz_us[SENSORES_NUM_LDR];  // Instante da leitura (us desde o boot)
+    uint64_t temperatura_us;
+} SensoresSnapshot;
+
+typedef struct
+{
+    uint32_t acertos; // Leituras servidas pelo cache
+    uint32_t falhas;  // Leituras que foram ao ADC
+} SensoresContadores;
+
+// Máscara de entradas que a aquisição deve amostrar: LDRs + temperatura
+#define SENSORES_ENTRADAS_ADC (SENSORES_ENTRADAS_LDR | (1u << 4))
+
+void init_sensores(void);
+
+// Cache de leituras compartilhado por publicadores, controle e estado JSON:
+// o ADC só é consultado quando o valor guardado passou da idade máxima.
+// 'entradas' escolhe os LDRs do cômodo (bit i = ADC i); a luz devolvida é a
+// média deles, em centésimos de porcento (0-10000).
+uint16_t sensores_luz(uint8_t entradas);
+uint16_t sensores_luz_atualizada(uint8_t entradas); // Ignora o cache (ex.: logo após mover a janela)
+float sensores_temperatura(void);
+// Leitura filtrada de um LDR na escala do filtro (12 + SENSORES_BITS_EXTRA bits),
+// antes da conversão pela tabela de calibração
+uint16_t sensores_ldr_bruto(uint entrada);
+void sensores_snapshot(SensoresSnapshot *snapshot);
+void sensores_set_idade_max(uint32_t luz_ms, uint32_t temperatura_ms);
+void sensores_contadores(SensoresContadores *contadores);
+
+#endif
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+"""Ponte do estado binário dos cômodos para os tópicos de texto.
+
+A placa compilada com MQTT_ESTADO_BINARIO=2 publica apenas
+/casa/<comodo>/estado/bin (estrutura EstadoBin de estado_bin.h). Este script
+assina esses tópicos e republica, retidos, os tópicos de texto que o IoT MQTT
+Panel e o MQTT Explorer já usam:
+
+    /casa/<comodo>/estado         JSON, no mesmo formato do firmware
+    /casa/<comodo>/janela/pos     "%.2f"
+    /casa/<comodo>/janela/estado  "on"/"off"
+    /casa/<comodo>/luz/estado     "on"/"off"
+
+Uso:
+    pip install paho-mqtt
+    python3 tools/estado_bin_bridge.py --host 10.0.0.196 --user admin --password admin
+    python3 tools/estado_bin_bridge.py --decode 0103...   # só decodifica um payload em hex
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+ESTADO_BIN_VERSAO = 1
+ESTADO_BIN = struct.Struct("<BBHHHh")  # versao, flags, luz, janela, alvo, temperatura
+
+LUZ_LIGADA = 1 << 0
+MODO_AUTO = 1 << 1
+MODO_DORMIR = 1 << 2
+SEM_TEMPERATURA = -32768  # ESTADO_BIN_SEM_TEMPERATURA
+
+
+def decodificar(payload):
+    if len(payload) < ESTADO_BIN.size:
+        raise ValueError("payload curto: %d bytes" % len(payload))
+    versao, flags, luz, janela, alvo, temperatura = ESTADO_BIN.unpack_from(payload)
+    if versao != ESTADO_BIN_VERSAO:
+        raise ValueError("versao desconhecida: %d" % versao)
+    return {
+        "luz": luz / 100.0,
+        "janela": janela / 100.0,
+        "iluminacao_alvo": alvo / 100.0,
+        "temperatura": None if temperatura == SEM_TEMPERATURA else temperatura / 100.0,
+        "luz_ligada": bool(flags & LUZ_LIGADA),
+        "modo_auto": bool(flags & MODO_AUTO),
+        "modo_dormir": bool(flags & MODO_DORMIR),
+    }
+
+
+def topicos_texto(comodo, e):
+    """Mesmos payloads de publish_estado()/publish_janela_*()/publish_luz_estado()."""
+    base = "/casa/%s" % comodo
+    estado = ('{"luz":%.2f,"janela":%.2f,"luz_ligada":%d,"modo":"%s","modo_dormir":%d,"iluminacao_alvo":%.2f}'
+              % (e["luz"], e["janela"], e["luz_ligada"], "auto" if e["modo_auto"] else "manual",
+                 e["modo_dormir"], e["iluminacao_alvo"]))
+    return [
+        (base + "/estado", estado),
+        (base + "/janela/pos", "%.2f" % e["janela"]),
+        (base + "/janela/estado", "on" if e["janela"] > 0.0 else "off"),
+        (base + "/luz/estado", "on" if e["luz_ligada"] else "off"),
+    ]
+
+
+def ponte(args):
+    import paho.mqtt.client as mqtt
+
+    ultimos = {}
+
+    def ao_conectar(cliente, _userdata, _flags, rc, *_):
+        print("conectado (rc=%s)" % rc)
+        cliente.subscribe("/casa/+/estado/bin", qos=1)
+
+    def ao_receber(cliente, _userdata, msg):
+        partes = msg.topic.split("/")  # ["", "casa", comodo, "estado", "bin"]
+        if len(partes) != 5:
+            return
+        try:
+            estado = decodificar(msg.payload)
+        except ValueError as erro:
+            print("%s: %s" % (msg.topic, erro), file=sys.stderr)
+            return
+        for topico, payload in topicos_texto(partes[2], estado):
+            if ultimos.get(topico) != payload:
+                ultimos[topico] = payload
+                cliente.publish(topico, payload, qos=1, retain=True)
+        if args.verbose:
+            print(partes[2], json.dumps(estado))
+
+    cliente = mqtt.Client()
+    if args.user:
+        cliente.username_pw_set(args.user, args.password)
+    cliente.on_connect = ao_conectar
+    cliente.on_message = ao_receber
+    cliente.connect(args.host, args.port)
+    cliente.loop_forever()
+
+
+def main():
+    p = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    p.add_argument("--host", default="10.0.0.196")
+    p.add_argument("--port", type=int, default=1883)
+    p.add_argument("--user", default="admin")
+    p.add_argument("--password", default="admin")
+    p.add_argument("--decode", metavar="HEX", help="decodifica um payload e sai")
+    p.add_argument("-v", "--verbose", action="store_true")
+    args = p.parse_args()
+
+    if args.decode:
+        estado = decodificar(bytes.fromhex(args.decode))
+        print(json.dumps(estado))
+        for topico, payload in topicos_texto("<comodo>", estado):
+            print(topico, payload)
+        return
+    ponte(args)
+
+
+if __name__ == "__main__":
+    main()
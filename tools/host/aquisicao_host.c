@@ -0,0 +1,119 @@
+#include "aquisicao.h"
+#include "host.h"
+
+// ADC simulado: cada entrada tem um valor constante definido pela bancada, e
+// host_adc_janela() repete o papel da interrupção do DMA
+
+static uint16_t valores[AQUISICAO_NUM_ENTRADAS];
+static uint16_t janela_amostras[AQUISICAO_MAX_AMOSTRAS];
+static uint8_t mascara_entradas;
+static uint32_t taxa_atual;
+static uint janela_atual;
+static aquisicao_processador_t processadores[AQUISICAO_NUM_ENTRADAS];
+
+void host_adc_set(uint entrada, uint16_t valor)
+{
+    if (entrada < AQUISICAO_NUM_ENTRADAS)
+    {
+        valores[entrada] = valor & 0xFFF;
+    }
+}
+
+void host_adc_janela(void)
+{
+    for (uint i = 0; i < AQUISICAO_NUM_ENTRADAS; i++)
+    {
+        if (!processadores[i])
+        {
+            continue;
+        }
+        for (uint k = 0; k < janela_atual; k++)
+        {
+            janela_amostras[k] = valores[i];
+        }
+        processadores[i](janela_amostras, janela_atual, 1);
+    }
+}
+
+static uint limitar_janela(uint janela)
+{
+    return (janela == 0) ? AQUISICAO_JANELA_PADRAO : (janela > AQUISICAO_MAX_AMOSTRAS ? AQUISICAO_MAX_AMOSTRAS : janela);
+}
+
+void init_aquisicao(uint8_t entradas, uint32_t taxa_hz, uint janela)
+{
+    mascara_entradas = entradas & AQUISICAO_ENTRADAS_VALIDAS;
+    if (!mascara_entradas)
+    {
+        mascara_entradas = 1;
+    }
+    janela_atual = limitar_janela(janela);
+    aquisicao_set_taxa(taxa_hz);
+}
+
+void aquisicao_set_taxa(uint32_t taxa_hz)
+{
+    taxa_atual = taxa_hz ? taxa_hz : AQUISICAO_TAXA_PADRAO;
+}
+
+bool aquisicao_set_janela(uint janela)
+{
+    if (janela == 0 || janela > AQUISICAO_MAX_AMOSTRAS)
+    {
+        return false;
+    }
+    janela_atual = janela;
+    return true;
+}
+
+uint32_t aquisicao_taxa(void)
+{
+    return taxa_atual;
+}
+
+uint aquisicao_janela(void)
+{
+    return janela_atual;
+}
+
+uint8_t aquisicao_entradas(void)
+{
+    return mascara_entradas;
+}
+
+void aquisicao_set_processador(uint entrada, aquisicao_processador_t fn)
+{
+    if (entrada < AQUISICAO_NUM_ENTRADAS)
+    {
+        processadores[entrada] = fn;
+    }
+}
+
+uint16_t aquisicao_ultima(uint entrada)
+{
+    return valores[entrada];
+}
+
+uint16_t aquisicao_media(uint entrada)
+{
+    return valores[entrada];
+}
+
+void aquisicao_estatisticas(uint entrada, AquisicaoEstatisticas *e)
+{
+    e->ultima = e->media = e->minimo = e->maximo = valores[entrada];
+    e->amostras = janela_atual;
+}
+
+void aquisicao_pausar(void)
+{
+}
+
+void aquisicao_retomar(void)
+{
+}
+
+uint16_t aquisicao_ler_unica(uint entrada)
+{
+    return valores[entrada];
+}
@@ -0,0 +1,193 @@
+// Bancada de desempenho da aplicação no host.
+//
+// Compila aplicacao.c, sensores.c, calibracao.c e os demais módulos sem o Pico
+// SDK, sobre os substitutos de hal_host.c e aquisicao_host.c, e mede:
+//   - ciclos do worker por segundo: o cômodo (tools/simulador/planta.c) alimenta
+//     o ADC simulado e cada ciclo roda sensores + automação + publicações;
+//   - comandos MQTT por segundo: mensagens entregues ao roteador como se
+//     viessem do broker.
+//
+//   bancada [--ciclos N] [--comandos N] [--eco] [--max-us-ciclo X] [--max-us-comando X]
+//
+// Com --max-us-*, termina com código 1 se o custo médio passar do limite, para
+// servir de teste de regressão de desempenho em CI.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "aplicacao.h"
+#include "aquisicao.h"
+#include "hal.h"
+#include "host.h"
+#include "planta.h"
+#include "publicacao.h"
+#include "sensores.h"
+
+#define CICLO_MS 2000       // TEMP_WORKER_TIME_S do firmware
+#define PASSO_PLANTA_MS 100 // Uma janela do ADC a cada 100 ms, como no Pico
+#define CICLOS_PADRAO 100000
+#define COMANDOS_PADRAO 200000
+#define INICIO_H 5.0
+
+static const PlantaDia dia = {"nublado", 6.0f, 18.0f, 0.9f, 0.7f, 90.0f};
+static const PlantaComodo comodo_planta = {"janela_grande", 90.0f, 1.0f, 3.0f, 35.0f, 0.5f, 0.5f};
+
+// Comandos variados, que mudam o estado e geram publicações
+static const struct
+{
+    const char *topico;
+    const char *payload;
+} comandos[] = {
+    {"/casa/sala/luz/set", "50"},
+    {"/casa/sala/janela/set", "30"},
+    {"/casa/sala/modo", "manual"},
+    {"/casa/sala/luz/ligar", "on"},
+    {"/casa/sala/janela/abrir", "off"},
+    {"/casa/sala/luz/ligar", "off"},
+    {"/casa/sala/modo", "auto"},
+    {"/casa/sala/luz/set", "65"},
+    {"/casa/select", "quarto1"},
+    {"/casa/quarto1/janela/set", "80"},
+    {"/casa/quarto1/modo_dormir", "on"},
+    {"/casa/quarto1/modo_dormir", "off"},
+    {"/casa/select", "sala"},
+    {"/casa/inexistente/modo", "auto"},
+    {"/led", "on"},
+    {"/led", "off"},
+};
+
+static double agora_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Leitura bruta do LDR para a luz pedida, pela reta de calibração padrão
+// (adc 100 -> 100%, 4000 -> 0%)
+static uint16_t luz_para_adc(uint16_t luz)
+{
+    return (uint16_t)(4000 - (uint32_t)luz * 3900 / COMODO_100_PORCENTO);
+}
+
+static void uso(const char *programa)
+{
+    fprintf(stderr, "uso: %s [--ciclos N] [--comandos N] [--eco] [--max-us-ciclo X] [--max-us-comando X]\n", programa);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    long ciclos = CICLOS_PADRAO, num_comandos = COMANDOS_PADRAO;
+    double max_us_ciclo = 0, max_us_comando = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 < argc && strcmp(argv[i], "--ciclos") == 0)
+        {
+            ciclos = atol(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--comandos") == 0)
+        {
+            num_comandos = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--eco") == 0)
+        {
+            host_mqtt_eco(true);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--max-us-ciclo") == 0)
+        {
+            max_us_ciclo = atof(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--max-us-comando") == 0)
+        {
+            max_us_comando = atof(argv[++i]);
+        }
+        else
+        {
+            uso(argv[0]);
+        }
+    }
+
+    // Mesma ordem do main() do firmware
+    init_hal();
+    init_aquisicao(SENSORES_ENTRADAS_ADC, AQUISICAO_TAXA_PADRAO, AQUISICAO_JANELA_PADRAO);
+    init_sensores();
+    init_aplicacao();
+    host_adc_set(AQUISICAO_ENTRADA_TEMPERATURA, 876); // ~27 °C
+    aplicacao_conectado();
+
+    Planta planta;
+    planta_init(&planta, &dia, &comodo_planta, INICIO_H, 1);
+
+    // Ciclos do worker, com a planta fechando a malha
+    double tempo_ciclos = 0;
+    HostAtuadores atuadores;
+    for (long n = 0; n < ciclos; n++)
+    {
+        for (uint t = 0; t < CICLO_MS; t += PASSO_PLANTA_MS)
+        {
+            host_atuadores(&atuadores);
+            planta.janela = atuadores.janela_pos;
+            planta.lampada_ligada = atuadores.luz_ligada;
+            planta_avancar(&planta, PASSO_PLANTA_MS / 1000.0);
+            host_avancar_us(PASSO_PLANTA_MS * 1000u);
+            for (uint i = 0; i < SENSORES_NUM_LDR; i++)
+            {
+                host_adc_set(i, luz_para_adc(planta_ler_ldr(&planta)));
+            }
+            host_adc_janela();
+        }
+        double inicio = agora_s();
+        aplicacao_ciclo();
+        tempo_ciclos += agora_s() - inicio;
+    }
+
+    HostMqtt mqtt;
+    host_mqtt(&mqtt);
+    uint32_t mensagens_ciclos = mqtt.mensagens;
+    host_atuadores(&atuadores);
+    uint32_t mudancas_ciclos = atuadores.mudancas;
+    uint32_t notificacoes_ciclos = atuadores.notificacoes;
+
+    // Comandos, sem avançar o relógio: mede só o roteamento e as publicações
+    double inicio = agora_s();
+    for (long n = 0; n < num_comandos; n++)
+    {
+        uint i = n % count_of(comandos);
+        aplicacao_mensagem(comandos[i].topico, comandos[i].payload);
+    }
+    double tempo_comandos = agora_s() - inicio;
+    host_mqtt(&mqtt);
+    host_atuadores(&atuadores);
+
+    double us_ciclo = ciclos ? tempo_ciclos * 1e6 / ciclos : 0;
+    double us_comando = num_comandos ? tempo_comandos * 1e6 / num_comandos : 0;
+    printf("ciclos:   %ld (%.1f h simuladas), %.3f us/ciclo, %.0f ciclos/s, %u mensagens, %u escritas nos atuadores\n",
+           ciclos, ciclos * (CICLO_MS / 1000.0) / 3600.0, us_ciclo, us_ciclo > 0 ? 1e6 / us_ciclo : 0,
+           mensagens_ciclos, mudancas_ciclos);
+    printf("comandos: %ld, %.3f us/comando, %.0f comandos/s, %u mensagens\n", num_comandos, us_comando,
+           us_comando > 0 ? 1e6 / us_comando : 0, mqtt.mensagens - mensagens_ciclos);
+    printf("eventos:  %u notificacoes nos ciclos, %u nos comandos\n", notificacoes_ciclos,
+           atuadores.notificacoes - notificacoes_ciclos);
+
+    PublicacaoContadores publicacoes;
+    publicacao_contadores(&publicacoes);
+    printf("publicacao: %u enviadas, %u suprimidas, %u falhas\n", publicacoes.enviadas, publicacoes.suprimidas,
+           publicacoes.falhas);
+
+    int resultado = 0;
+    if (max_us_ciclo > 0 && us_ciclo > max_us_ciclo)
+    {
+        fprintf(stderr, "regressao: %.3f us/ciclo > %.3f\n", us_ciclo, max_us_ciclo);
+        resultado = 1;
+    }
+    if (max_us_comando > 0 && us_comando > max_us_comando)
+    {
+        fprintf(stderr, "regressao: %.3f us/comando > %.3f\n", us_comando, max_us_comando);
+        resultado = 1;
+    }
+    return resultado;
+}
@@ -0,0 +1,133 @@
+#include "hal.h"
+#include "host.h"
+#include "ciclos.h"
+#include "hardware/flash.h"
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Substitutos do hardware e do cliente MQTT para rodar aplicacao.c no PC
+
+static uint64_t relogio_us;
+static HostAtuadores atuadores;
+static HostMqtt mqtt;
+static bool eco;
+
+uint8_t host_flash[PICO_FLASH_SIZE_BYTES];
+
+uint64_t time_us_64(void)
+{
+    return relogio_us;
+}
+
+void host_avancar_us(uint64_t us)
+{
+    relogio_us += us;
+}
+
+uint32_t hal_agora_ms(void)
+{
+    return (uint32_t)(relogio_us / 1000);
+}
+
+// Ciclos = nanossegundos reais do host, para os DEBUG_printf de custo por ciclo
+void init_ciclos(void)
+{
+}
+
+uint64_t ciclos_agora(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+void panic(const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+    exit(1);
+}
+
+void init_hal(void)
+{
+    memset(&atuadores, 0, sizeof(atuadores));
+}
+
+void hal_set_janela(uint16_t pos)
+{
+    atuadores.janela_pos = pos;
+    atuadores.mudancas++;
+}
+
+void hal_set_luz(bool on)
+{
+    atuadores.luz_ligada = on;
+    atuadores.mudancas++;
+}
+
+void hal_set_led(bool on)
+{
+    atuadores.led = on;
+    atuadores.mudancas++;
+}
+
+void hal_notificar(uint32_t eventos)
+{
+    atuadores.eventos |= eventos;
+    atuadores.notificacoes++;
+}
+
+void host_atuadores(HostAtuadores *a)
+{
+    *a = atuadores;
+}
+
+bool hal_mqtt_publicar(const char *topico, const void *payload, uint16_t len, bool retain, SaidaPrioridade prioridade)
+{
+    mqtt.mensagens++;
+    mqtt.bytes += len;
+    strncpy(mqtt.topico, topico, sizeof(mqtt.topico) - 1);
+    uint16_t n = len < sizeof(mqtt.payload) - 1 ? len : sizeof(mqtt.payload) - 1;
+    memcpy(mqtt.payload, payload, n);
+    mqtt.payload[n] = '\0';
+    if (eco)
+    {
+        printf("[%8.3f] %s%s %s\n", relogio_us / 1e6, topico, retain ? " (retido)" : "", mqtt.payload);
+    }
+    return true;
+}
+
+const char *hal_mqtt_topico(const char *nome)
+{
+    return nome;
+}
+
+void hal_mqtt_encerrar(void)
+{
+    mqtt.encerrado = true;
+}
+
+void host_mqtt(HostMqtt *m)
+{
+    *m = mqtt;
+}
+
+void host_mqtt_eco(bool ligado)
+{
+    eco = ligado;
+}
+
+void flash_range_erase(uint32_t offset, size_t count)
+{
+    memset(&host_flash[offset], 0xFF, count);
+}
+
+void flash_range_program(uint32_t offset, const uint8_t *data, size_t count)
+{
+    memcpy(&host_flash[offset], data, count);
+}
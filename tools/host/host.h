@@ -0,0 +1,43 @@
+#ifndef HOST_H
+#define HOST_H
+
+#include "pico/stdlib.h"
+
+// Controles dos substitutos do hardware no build do host: o programa que roda
+// a aplicação (bancada.c) avança o relógio, define as leituras do ADC e
+// inspeciona os atuadores e as mensagens MQTT.
+
+// Relógio simulado (time_us_64, hal_agora_ms)
+void host_avancar_us(uint64_t us);
+
+// ADC: valor bruto (12 bits) de cada entrada; host_adc_janela() entrega uma
+// janela completa aos processadores, como a interrupção do DMA no Pico
+void host_adc_set(uint entrada, uint16_t valor);
+void host_adc_janela(void);
+
+typedef struct
+{
+    uint16_t janela_pos;
+    bool luz_ligada;
+    bool led;
+    uint32_t mudancas; // Escritas no servo, relé ou LED
+    uint32_t eventos;  // EVENTO_* já notificados (hal_notificar)
+    uint32_t notificacoes;
+} HostAtuadores;
+
+void host_atuadores(HostAtuadores *a);
+
+// MQTT em memória: as mensagens são contadas e a última fica guardada
+typedef struct
+{
+    uint32_t mensagens;
+    uint32_t bytes;
+    bool encerrado;      // /exit recebido
+    char topico[128];    // Última mensagem
+    char payload[256];
+} HostMqtt;
+
+void host_mqtt(HostMqtt *m);
+void host_mqtt_eco(bool ligado); // Imprime cada mensagem publicada
+
+#endif
@@ -0,0 +1,10 @@
+#ifndef HOST_CONFIG_H
+#define HOST_CONFIG_H
+
+// Incluído antes de cada arquivo (-include): os logs da aplicação custariam
+// mais que a própria lógica medida pela bancada, que mede o build de release
+#define INFO_printf(...)
+#define DEBUG_printf(...)
+#define NDEBUG
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef HOST_HARDWARE_DMA_H
+#define HOST_HARDWARE_DMA_H
+
+#include "pico/stdlib.h"
+
+// Sem canais no host: ssd1306_init_dma() falha e fica só o transporte bloqueante
+typedef struct
+{
+    uint32_t ctrl;
+} dma_channel_config;
+
+enum dma_channel_transfer_size
+{
+    DMA_SIZE_8,
+    DMA_SIZE_16,
+    DMA_SIZE_32
+};
+
+static inline int dma_claim_unused_channel(bool required)
+{
+    return -1;
+}
+
+static inline void dma_channel_unclaim(uint channel)
+{
+}
+
+static inline void dma_channel_abort(uint channel)
+{
+}
+
+static inline dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    dma_channel_config c = {0};
+    return c;
+}
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size)
+{
+}
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr)
+{
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr)
+{
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq)
+{
+}
+
+static inline void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                                         const volatile void *read_addr, uint transfer_count, bool trigger)
+{
+}
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef HOST_HARDWARE_IRQ_H
+#define HOST_HARDWARE_IRQ_H
+
+#include "pico/stdlib.h"
+
+typedef void (*irq_handler_t)(void);
+
+#define I2C0_IRQ 23
+#define I2C1_IRQ 24
+
+static inline void irq_set_exclusive_handler(uint num, irq_handler_t handler)
+{
+}
+
+static inline void irq_set_enabled(uint num, bool enabled)
+{
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef HOST_PICO_STDLIB_H
+#define HOST_PICO_STDLIB_H
+
+// Substituto mínimo do pico/stdlib.h para compilar no host os módulos que não
+// tocam no hardware direto (controle.c, formato.c, publicacao.c, aplicacao.c...)
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define __unused __attribute__((unused))
+
+uint64_t time_us_64(void); // Relógio simulado: simulador.c ou hal_host.c
+void panic(const char *fmt, ...);
+
+#endif
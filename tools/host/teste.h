@@ -0,0 +1,36 @@
+#ifndef TESTE_H
+#define TESTE_H
+
+// Verificações mínimas dos testes do host (ctest): cada falha é impressa e o
+// programa termina com teste_resultado(), 1 se alguma falhou
+#include <stdio.h>
+#include <time.h>
+
+static int teste_falhas = 0;
+
+#define VERIFICAR(cond, ...)                                    \
+    do                                                          \
+    {                                                           \
+        if (!(cond))                                            \
+        {                                                       \
+            printf("FALHOU %s:%d: ", __FILE__, __LINE__);       \
+            printf(__VA_ARGS__);                                \
+            printf("\n");                                       \
+            teste_falhas++;                                     \
+        }                                                       \
+    } while (0)
+
+static inline double teste_agora_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static inline int teste_resultado(const char *nome)
+{
+    printf("%s: %s\n", nome, teste_falhas ? "FALHOU" : "ok");
+    return teste_falhas ? 1 : 0;
+}
+
+#endif
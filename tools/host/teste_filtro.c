@@ -0,0 +1,173 @@
+// Teste e bancada da cadeia de filtros do LDR (filtro.c), com a configuração de
+// sensores.c: mediana, notch no dobro da rede, sobreamostragem e passa-baixa.
+//
+//   teste_filtro [--amostras N]
+//
+// Verifica a rejeição de picos, a atenuação na frequência da rede e o ganho em
+// DC; depois mede o custo por amostra de cada estágio e da cadeia completa.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "filtro.h"
+#include "aquisicao.h"
+#include "sensores.h"
+#include "teste.h"
+
+#define TAXA AQUISICAO_TAXA_PADRAO
+#define FREQ_NOTCH (2 * SENSORES_FREQ_REDE_HZ)
+#define AMOSTRAS_PADRAO 10000000L
+
+static void filtro_sensores(Filtro *f)
+{
+    filtro_init(f);
+    filtro_config_mediana(f, SENSORES_MEDIANA);
+    filtro_config_notch(f, FREQ_NOTCH, TAXA, 0.95f);
+    filtro_config_sobreamostragem(f, SENSORES_BITS_EXTRA);
+    filtro_config_passa_baixa(f, SENSORES_PASSA_BAIXA_K);
+}
+
+// Amplitude (pico a pico / 2) da saída do notch sozinho para uma senoide em 'freq_hz'
+static double amplitude_notch(double freq_hz)
+{
+    Filtro f;
+    filtro_init(&f);
+    filtro_config_notch(&f, FREQ_NOTCH, TAXA, 0.95f);
+    int32_t min = INT32_MAX, max = INT32_MIN;
+    for (int n = 0; n < 4 * TAXA; n++)
+    {
+        int32_t x = 2000 + lround(500.0 * sin(2.0 * M_PI * freq_hz * n / TAXA));
+        filtro_amostra(&f, x);
+        if (n >= 2 * TAXA) // Depois do transitório
+        {
+            int32_t y = filtro_saida(&f);
+            min = y < min ? y : min;
+            max = y > max ? y : max;
+        }
+    }
+    return (max - min) / 2.0;
+}
+
+static void testar_picos(void)
+{
+    // Mediana de 5: picos isolados nunca chegam à saída
+    Filtro f;
+    filtro_init(&f);
+    filtro_config_mediana(&f, SENSORES_MEDIANA);
+    for (int n = 0; n < 1000; n++)
+    {
+        filtro_amostra(&f, n % 37 == 36 ? 4095 : 1000);
+        VERIFICAR(filtro_saida(&f) == 1000, "mediana deixou passar pico: amostra %d saida %d", n, filtro_saida(&f));
+    }
+
+    // Cadeia completa: um pico a cada 37 amostras não desloca o nível medido
+    filtro_sensores(&f);
+    int32_t esperado = 1000 << SENSORES_BITS_EXTRA;
+    for (int n = 0; n < 4 * TAXA; n++)
+    {
+        if (filtro_amostra(&f, n % 37 == 36 ? 4095 : 1000) && n >= TAXA)
+        {
+            VERIFICAR(abs(filtro_saida(&f) - esperado) <= 1, "cadeia com picos: saida %d, esperado %d",
+                      filtro_saida(&f), esperado);
+        }
+    }
+}
+
+static void testar_notch(void)
+{
+    double na_rede = amplitude_notch(FREQ_NOTCH);
+    double fora = amplitude_notch(10.0);
+    double atenuacao_db = 20.0 * log10(na_rede > 0.5 ? na_rede / 500.0 : 0.5 / 500.0);
+    printf("notch: %d Hz -> amplitude %.1f de 500 (%.1f dB); 10 Hz -> %.1f\n", FREQ_NOTCH, na_rede, atenuacao_db, fora);
+    VERIFICAR(atenuacao_db <= -30.0, "notch atenua so %.1f dB em %d Hz", atenuacao_db, FREQ_NOTCH);
+    VERIFICAR(fora >= 450.0, "notch atenua demais fora da rede: %.1f de 500 em 10 Hz", fora);
+}
+
+static void testar_dc(void)
+{
+    static const int32_t niveis[] = {0, 1, 100, 2048, 4000, 4095};
+    for (unsigned i = 0; i < sizeof(niveis) / sizeof(niveis[0]); i++)
+    {
+        Filtro f;
+        filtro_sensores(&f);
+        for (int n = 0; n < TAXA; n++)
+        {
+            filtro_amostra(&f, niveis[i]);
+        }
+        int32_t esperado = niveis[i] << SENSORES_BITS_EXTRA;
+        VERIFICAR(abs(filtro_saida(&f) - esperado) <= 1, "ganho DC: entrada %d saida %d, esperado %d", niveis[i],
+                  filtro_saida(&f), esperado);
+    }
+}
+
+static int32_t *sinal;
+static long num_sinal;
+
+static void medir(const char *nome, const Filtro *config)
+{
+    Filtro f = *config;
+    volatile int32_t soma = 0;
+    double inicio = teste_agora_s();
+    for (long n = 0; n < num_sinal; n++)
+    {
+        if (filtro_amostra(&f, sinal[n]))
+        {
+            soma += filtro_saida(&f);
+        }
+    }
+    double ns = (teste_agora_s() - inicio) * 1e9 / num_sinal;
+    printf("  %-16s %6.2f ns/amostra\n", nome, ns);
+}
+
+static void bancada(long amostras)
+{
+    // Luz com cintilação da rede e picos, como um LDR sob lâmpada
+    num_sinal = amostras;
+    sinal = malloc(amostras * sizeof(*sinal));
+    srand(1);
+    for (long n = 0; n < amostras; n++)
+    {
+        sinal[n] = 2000 + lround(200.0 * sin(2.0 * M_PI * FREQ_NOTCH * n / TAXA)) + rand() % 16;
+        if (rand() % 100 == 0)
+        {
+            sinal[n] = 4095;
+        }
+    }
+
+    Filtro f;
+    printf("bancada (%ld amostras):\n", amostras);
+    filtro_init(&f);
+    filtro_config_mediana(&f, SENSORES_MEDIANA);
+    medir("mediana", &f);
+    filtro_init(&f);
+    filtro_config_notch(&f, FREQ_NOTCH, TAXA, 0.95f);
+    medir("notch", &f);
+    filtro_init(&f);
+    filtro_config_sobreamostragem(&f, SENSORES_BITS_EXTRA);
+    medir("decimacao", &f);
+    filtro_init(&f);
+    filtro_config_passa_baixa(&f, SENSORES_PASSA_BAIXA_K);
+    medir("passa-baixa", &f);
+    filtro_sensores(&f);
+    medir("cadeia completa", &f);
+    free(sinal);
+}
+
+int main(int argc, char **argv)
+{
+    long amostras = AMOSTRAS_PADRAO;
+    if (argc == 3 && strcmp(argv[1], "--amostras") == 0)
+    {
+        amostras = atol(argv[2]);
+    }
+
+    testar_picos();
+    testar_notch();
+    testar_dc();
+    if (amostras > 0)
+    {
+        bancada(amostras);
+    }
+    return teste_resultado("filtro");
+}
@@ -0,0 +1,150 @@
+// Teste e bancada da formatação sem printf (formato.c).
+//
+//   teste_formato [--valores N]
+//
+// formato_decimal2 e formato_centesimos têm de escrever exatamente o que o
+// snprintf("%.2f") escreve: compara N floats aleatórios e todos os centésimos
+// de -200.00 a 200.00. Verifica também a leitura de centésimos, inclusive os
+// valores que não cabem em int32_t, e mede o custo contra o snprintf.
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "formato.h"
+#include "teste.h"
+
+#define VALORES_PADRAO 3000000L
+
+static uint32_t semente = 12345;
+
+static uint32_t aleatorio(void)
+{
+    // xorshift32: a mesma sequência em qualquer host
+    semente ^= semente << 13;
+    semente ^= semente >> 17;
+    semente ^= semente << 5;
+    return semente;
+}
+
+// Metade uniforme em [-1000, 1000], metade com bits aleatórios e |v| < 2^40
+static float float_aleatorio(void)
+{
+    if (aleatorio() & 1)
+    {
+        return (float)((int32_t)(aleatorio() % 2000001u) - 1000000) / 1000.0f;
+    }
+    uint32_t bits = aleatorio();
+    uint32_t exp = (bits >> 23) & 0xFF;
+    if (exp > 127 + 39)
+    {
+        bits = (bits & ~(0xFFu << 23)) | ((exp % (127 + 40)) << 23);
+    }
+    float v;
+    memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+static void comparar_decimal2(float v)
+{
+    char esperado[64], obtido[64];
+    snprintf(esperado, sizeof(esperado), "%.2f", v);
+    size_t n = formato_decimal2(obtido, sizeof(obtido), v);
+    VERIFICAR(strcmp(esperado, obtido) == 0 && n == strlen(esperado), "%a: snprintf '%s', formato '%s'", v,
+              esperado, obtido);
+}
+
+static void testar_decimal2(long valores)
+{
+    for (long i = 0; i < valores && !teste_falhas; i++)
+    {
+        comparar_decimal2(float_aleatorio());
+    }
+    for (int32_t c = -20000; c <= 20000; c++)
+    {
+        comparar_decimal2((float)c / 100.0f);
+
+        char esperado[32], obtido[32];
+        snprintf(esperado, sizeof(esperado), "%.2f", c / 100.0);
+        formato_centesimos(obtido, sizeof(obtido), c);
+        VERIFICAR(strcmp(esperado, obtido) == 0, "centesimos %d: '%s', esperado '%s'", c, obtido, esperado);
+
+        int32_t lido;
+        VERIFICAR(formato_ler_centesimos(obtido, &lido) && lido == c, "ler '%s' devolveu %d", obtido, lido);
+    }
+    comparar_decimal2(INFINITY);
+    comparar_decimal2(-INFINITY);
+    comparar_decimal2(-0.0f);
+    comparar_decimal2(0.005f);
+    comparar_decimal2(0.015f);
+}
+
+static void testar_leitura(void)
+{
+    static const struct
+    {
+        const char *texto;
+        bool ok;
+        int32_t centesimos;
+    } casos[] = {
+        {"65.5", true, 6550},          {" -1.005", true, -101},         {"+2", true, 200},
+        {".5", true, 50},              {"12abc", true, 1200},           {"", false, 0},
+        {"-", false, 0},               {"abc", false, 0},               {"21474836.47", true, INT32_MAX},
+        {"-21474836.47", true, -INT32_MAX}, {"21474836.48", false, 0},  {"21474837", false, 0},
+        {"99999999999", false, 0},     {"-99999999999", false, 0},
+    };
+    for (unsigned i = 0; i < sizeof(casos) / sizeof(casos[0]); i++)
+    {
+        int32_t lido = 0;
+        bool ok = formato_ler_centesimos(casos[i].texto, &lido);
+        VERIFICAR(ok == casos[i].ok && (!ok || lido == casos[i].centesimos), "ler '%s': %d %d, esperado %d %d",
+                  casos[i].texto, ok, lido, casos[i].ok, casos[i].centesimos);
+    }
+}
+
+static void bancada(long valores)
+{
+    float *v = malloc(valores * sizeof(*v));
+    for (long i = 0; i < valores; i++)
+    {
+        v[i] = (float)((int32_t)(aleatorio() % 20001u) - 10000) / 100.0f; // Faixa das porcentagens
+    }
+    char buf[32];
+    volatile size_t total = 0;
+
+    double inicio = teste_agora_s();
+    for (long i = 0; i < valores; i++)
+    {
+        total += formato_decimal2(buf, sizeof(buf), v[i]);
+    }
+    double ns_formato = (teste_agora_s() - inicio) * 1e9 / valores;
+
+    inicio = teste_agora_s();
+    for (long i = 0; i < valores; i++)
+    {
+        total += snprintf(buf, sizeof(buf), "%.2f", v[i]);
+    }
+    double ns_snprintf = (teste_agora_s() - inicio) * 1e9 / valores;
+
+    printf("bancada (%ld valores):\n", valores);
+    printf("  formato_decimal2 %6.1f ns/valor\n", ns_formato);
+    printf("  snprintf %%.2f    %6.1f ns/valor\n", ns_snprintf);
+    free(v);
+}
+
+int main(int argc, char **argv)
+{
+    long valores = VALORES_PADRAO;
+    if (argc == 3 && strcmp(argv[1], "--valores") == 0)
+    {
+        valores = atol(argv[2]);
+    }
+
+    testar_decimal2(valores);
+    testar_leitura();
+    if (valores > 0)
+    {
+        bancada(valores);
+    }
+    return teste_resultado("formato");
+}
@@ -0,0 +1,185 @@
+// Teste e bancada do roteador de tópicos (rotas.c).
+//
+//   teste_rotas [--despachos N]
+//
+// Verifica que cada tópico de COMODO_COMANDOS, em cada cômodo, e cada rota
+// global chegam ao handler certo e que tópicos desconhecidos não casam. Depois
+// compara o custo por despacho com a cadeia de strcmp que o roteador substituiu.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "comodos.h"
+#include "rotas.h"
+#include "teste.h"
+
+#define DESPACHOS_PADRAO 5000000L
+
+// Handlers de teste com os mesmos nomes de aplicacao.c: cada um só registra a chamada
+enum
+{
+#define ROTA_ID(nome, handler, caminho) ID_##handler,
+    COMODO_COMANDOS(ROTA_ID, "")
+#undef ROTA_ID
+    ID_GLOBAL_LED,
+    ID_GLOBAL_SELECT,
+    NUM_IDS
+};
+
+static int ultimo_id;
+static Comodo *ultimo_comodo;
+
+#define ROTA_HANDLER(nome, handler, caminho)                                                \
+    static void handler(void *ctx, Comodo *comodo, const char *topico, const char *payload) \
+    {                                                                                       \
+        ultimo_id = ID_##handler;                                                           \
+        ultimo_comodo = comodo;                                                             \
+    }
+COMODO_COMANDOS(ROTA_HANDLER, "")
+#undef ROTA_HANDLER
+
+static void rota_led(void *ctx, Comodo *comodo, const char *topico, const char *payload)
+{
+    ultimo_id = ID_GLOBAL_LED;
+    ultimo_comodo = comodo;
+}
+
+static void rota_select(void *ctx, Comodo *comodo, const char *topico, const char *payload)
+{
+    ultimo_id = ID_GLOBAL_SELECT;
+    ultimo_comodo = comodo;
+}
+
+#define ROTA_COMODO(nome, handler, caminho) {caminho, handler},
+static const Rota rotas_comodo[] = {COMODO_COMANDOS(ROTA_COMODO, "")};
+#undef ROTA_COMODO
+
+static const Rota rotas_globais[] = {
+    {"/led", rota_led},
+    {"/casa/select", rota_select},
+};
+
+static const char *const caminhos[] = {
+#define ROTA_CAMINHO(nome, handler, caminho) caminho,
+    COMODO_COMANDOS(ROTA_CAMINHO, "")
+#undef ROTA_CAMINHO
+};
+
+static bool despachar(const char *topico)
+{
+    ultimo_id = -1;
+    ultimo_comodo = NULL;
+    return rotas_despachar(NULL, topico, "x");
+}
+
+static void testar_rotas(void)
+{
+    char topico[128];
+    for (uint c = 0; c < NUM_COMODOS; c++)
+    {
+        for (uint r = 0; r < count_of(caminhos); r++)
+        {
+            snprintf(topico, sizeof(topico), "/casa/%s/%s", comodos[c]->nome, caminhos[r]);
+            VERIFICAR(despachar(topico), "%s sem rota", topico);
+            VERIFICAR(ultimo_id == (int)r, "%s foi para o handler %d, esperado %u", topico, ultimo_id, r);
+            VERIFICAR(ultimo_comodo == comodos[c], "%s resolveu o cômodo errado", topico);
+        }
+    }
+
+    VERIFICAR(despachar("/led") && ultimo_id == ID_GLOBAL_LED && !ultimo_comodo, "/led");
+    VERIFICAR(despachar("/casa/select") && ultimo_id == ID_GLOBAL_SELECT && !ultimo_comodo, "/casa/select");
+
+    static const char *const desconhecidos[] = {
+        "/casa/sala/inexistente", "/casa/inexistente/modo", "/casa/salao/modo", "/casa/sal/modo",
+        "/casa/sala/modo/x",      "/casa/sala/",            "/casa/sala",       "/casa/",
+        "/casa/sala/luz",         "/led/x",                 "/le",              "",
+    };
+    for (uint i = 0; i < count_of(desconhecidos); i++)
+    {
+        VERIFICAR(!despachar(desconhecidos[i]) && ultimo_id == -1, "'%s' não deveria ter rota", desconhecidos[i]);
+    }
+}
+
+// A cadeia de antes: strcmp do tópico completo contra cada rota global e cada
+// "/casa/<comodo>/<caminho>", depois o cômodo pelo prefixo
+static bool despachar_strcmp(const char *topico)
+{
+    for (uint i = 0; i < count_of(rotas_globais); i++)
+    {
+        if (strcmp(topico, rotas_globais[i].caminho) == 0)
+        {
+            rotas_globais[i].handler(NULL, NULL, topico, "x");
+            return true;
+        }
+    }
+    for (uint i = 0; i < comodos_num_assinaturas; i++)
+    {
+        if (strcmp(topico, comodos_assinaturas[i]) == 0)
+        {
+            Comodo *comodo = comodos[i / count_of(rotas_comodo)];
+            rotas_comodo[i % count_of(rotas_comodo)].handler(NULL, comodo, topico, "x");
+            return true;
+        }
+    }
+    return false;
+}
+
+static void bancada(long despachos)
+{
+    // Todos os tópicos de comando, as rotas globais e um desconhecido
+    const char *topicos[NUM_COMODOS * count_of(caminhos) + 3];
+    uint n = 0;
+    for (uint i = 0; i < comodos_num_assinaturas; i++)
+    {
+        topicos[n++] = comodos_assinaturas[i];
+    }
+    topicos[n++] = "/led";
+    topicos[n++] = "/casa/select";
+    topicos[n++] = "/casa/sala/inexistente";
+
+    for (uint i = 0; i < n; i++)
+    {
+        VERIFICAR(despachar(topicos[i]) == despachar_strcmp(topicos[i]), "cadeia de strcmp diverge em %s", topicos[i]);
+    }
+
+    volatile uint acertos = 0;
+    double inicio = teste_agora_s();
+    for (long i = 0; i < despachos; i++)
+    {
+        acertos += rotas_despachar(NULL, topicos[i % n], "x");
+    }
+    double ns_hash = (teste_agora_s() - inicio) * 1e9 / despachos;
+
+    inicio = teste_agora_s();
+    for (long i = 0; i < despachos; i++)
+    {
+        acertos += despachar_strcmp(topicos[i % n]);
+    }
+    double ns_strcmp = (teste_agora_s() - inicio) * 1e9 / despachos;
+
+    printf("bancada (%ld despachos, %u tópicos):\n", despachos, n);
+    printf("  hash          %6.1f ns/despacho\n", ns_hash);
+    printf("  strcmp        %6.1f ns/despacho\n", ns_strcmp);
+}
+
+int main(int argc, char **argv)
+{
+    long despachos = DESPACHOS_PADRAO;
+    if (argc == 3 && strcmp(argv[1], "--despachos") == 0)
+    {
+        despachos = atol(argv[2]);
+    }
+
+    bool ok = init_rotas(comodos, count_of(comodos), rotas_comodo, count_of(rotas_comodo), rotas_globais,
+                         count_of(rotas_globais));
+    VERIFICAR(ok, "init_rotas falhou");
+    if (ok)
+    {
+        testar_rotas();
+        if (despachos > 0)
+        {
+            bancada(despachos);
+        }
+    }
+    return teste_resultado("rotas");
+}
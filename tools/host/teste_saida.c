@@ -0,0 +1,250 @@
+// Teste e bancada da fila de saída do MQTT (saida.c) com a camada de publicação.
+//
+//   teste_saida [--mensagens N]
+//
+// Com um cliente MQTT de mentira, que aceita ou recusa conforme o teste,
+// verifica a mescla por tópico, a ordem por prioridade e o descarte com a fila
+// cheia. Depois liga a publicacao.c à fila como o main.c faz e verifica que um
+// tópico descartado da fila volta a sair no ciclo seguinte, em vez de ficar
+// suprimido até o heartbeat. Por fim mede o custo por mensagem.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "publicacao.h"
+#include "saida.h"
+#include "teste.h"
+
+#define MENSAGENS_PADRAO 2000000L
+#define CICLO_US 2000000u // TEMP_WORKER_TIME_S do firmware
+#define MAX_ENVIADAS 64
+
+static uint64_t relogio_us;
+
+uint64_t time_us_64(void)
+{
+    return relogio_us;
+}
+
+// Cliente MQTT: guarda o que recebeu; recusando, as mensagens ficam na fila
+static bool aceitar;
+static uint num_enviadas;
+static struct
+{
+    char topico[SAIDA_TOPICO_MAX];
+    char payload[16];
+} enviadas[MAX_ENVIADAS];
+
+static bool enviar(void *contexto, const char *topico, const void *payload, uint16_t len, bool retain)
+{
+    if (!aceitar)
+    {
+        return false;
+    }
+    if (num_enviadas < MAX_ENVIADAS)
+    {
+        strcpy(enviadas[num_enviadas].topico, topico);
+        uint16_t n = len < sizeof(enviadas[0].payload) - 1 ? len : sizeof(enviadas[0].payload) - 1;
+        memcpy(enviadas[num_enviadas].payload, payload, n);
+        enviadas[num_enviadas].payload[n] = '\0';
+    }
+    num_enviadas++;
+    return true;
+}
+
+// Mesma ligação do main.c no modo de um núcleo (lá, por aplicacao_descartada)
+static uint num_descartes;
+static char ultimo_descarte[SAIDA_TOPICO_MAX];
+
+static void descartada(void *contexto, const char *topico)
+{
+    num_descartes++;
+    strcpy(ultimo_descarte, topico);
+    uint slot;
+    publicacao_invalidar(topico, &slot);
+}
+
+static bool transporte(void *contexto, uint slot, const char *topico, const void *payload, uint16_t len, bool retain)
+{
+    return saida_enfileirar(topico, payload, len, retain, SAIDA_TELEMETRIA);
+}
+
+static bool enfileirar(const char *topico, const char *payload, SaidaPrioridade prioridade)
+{
+    return saida_enfileirar(topico, payload, (uint16_t)strlen(payload), false, prioridade);
+}
+
+// Posição do tópico entre as enviadas desde reiniciar_envios(), -1 se não saiu
+static int posicao(const char *topico, const char *payload)
+{
+    for (uint i = 0; i < num_enviadas && i < MAX_ENVIADAS; i++)
+    {
+        if (strcmp(enviadas[i].topico, topico) == 0 && (!payload || strcmp(enviadas[i].payload, payload) == 0))
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+static void reiniciar_envios(bool aceita)
+{
+    aceitar = aceita;
+    num_enviadas = 0;
+    num_descartes = 0;
+}
+
+// Broker respondendo: confirma as publicações em voo até a fila esvaziar
+static void escoar(void)
+{
+    aceitar = true;
+    SaidaContadores c;
+    do
+    {
+        saida_concluida(true);
+        saida_contadores(&c);
+    } while (c.em_voo > 0 || c.profundidade > 0);
+}
+
+static void testar_mescla(void)
+{
+    SaidaContadores antes, depois;
+    saida_contadores(&antes);
+    reiniciar_envios(false);
+    enfileirar("/casa/sala/luz", "10.00", SAIDA_TELEMETRIA);
+    enfileirar("/casa/sala/luz", "11.00", SAIDA_TELEMETRIA);
+    saida_contadores(&depois);
+    VERIFICAR(depois.mescladas - antes.mescladas == 1, "mescla: %u mescladas", depois.mescladas - antes.mescladas);
+    VERIFICAR(depois.profundidade == 1, "mescla: profundidade %u", depois.profundidade);
+
+    escoar();
+    VERIFICAR(num_enviadas == 1 && posicao("/casa/sala/luz", "11.00") == 0, "mescla: %u enviadas, sem o valor novo",
+              num_enviadas);
+}
+
+static void testar_prioridade(void)
+{
+    reiniciar_envios(false);
+    enfileirar("/casa/horario", "12:00", SAIDA_TELEMETRIA);
+    enfileirar("/casa/sala/estado", "a", SAIDA_ESTADO);
+    enfileirar("/led/state", "On", SAIDA_RESPOSTA);
+    enfileirar("/casa/sala/luz", "50.00", SAIDA_TELEMETRIA);
+    enfileirar("/casa/sala/luz", "51.00", SAIDA_RESPOSTA); // Sobe para o fim das respostas
+    escoar();
+
+    int resposta = posicao("/led/state", NULL);
+    int promovida = posicao("/casa/sala/luz", "51.00");
+    int estado = posicao("/casa/sala/estado", NULL);
+    int telemetria = posicao("/casa/horario", NULL);
+    VERIFICAR(num_enviadas == 4, "prioridade: %u enviadas, esperadas 4", num_enviadas);
+    VERIFICAR(resposta == 0 && promovida == 1 && estado == 2 && telemetria == 3,
+              "prioridade: ordem %d %d %d %d, esperada 0 1 2 3", resposta, promovida, estado, telemetria);
+}
+
+static void testar_fila_cheia(void)
+{
+    SaidaContadores antes, depois;
+    char topico[32];
+    saida_contadores(&antes);
+    reiniciar_envios(false);
+    for (uint i = 0; i < SAIDA_MAX_ITENS; i++)
+    {
+        snprintf(topico, sizeof(topico), "/resposta/%u", i);
+        VERIFICAR(enfileirar(topico, "x", SAIDA_RESPOSTA), "fila cheia: %s recusada antes de encher", topico);
+    }
+    // Sem nada menos importante para descartar, a mensagem nova é que fica de fora
+    VERIFICAR(!enfileirar("/resposta/extra", "x", SAIDA_RESPOSTA), "fila cheia: aceitou além de SAIDA_MAX_ITENS");
+    saida_contadores(&depois);
+    VERIFICAR(depois.descartadas - antes.descartadas == 1 && num_descartes == 0,
+              "fila cheia: %u descartadas, %u avisos", depois.descartadas - antes.descartadas, num_descartes);
+    escoar();
+    VERIFICAR(num_enviadas == SAIDA_MAX_ITENS, "fila cheia: %u enviadas", num_enviadas);
+}
+
+static void testar_reenvio(void)
+{
+    char topico[32];
+    reiniciar_envios(false);
+    VERIFICAR(publicacao_publicar(0, "/casa/sala/luz", "10.00", true), "reenvio: slot 0 não publicou");
+    VERIFICAR(publicacao_publicar(1, "/casa/quarto1/luz", "20.00", true), "reenvio: slot 1 não publicou");
+
+    // Respostas enchem a fila; a última tira a telemetria mais nova (slot 1)
+    for (uint i = 0; i < SAIDA_MAX_ITENS - 1; i++)
+    {
+        snprintf(topico, sizeof(topico), "/resposta/%u", i);
+        enfileirar(topico, "x", SAIDA_RESPOSTA);
+    }
+    VERIFICAR(num_descartes == 1 && strcmp(ultimo_descarte, "/casa/quarto1/luz") == 0,
+              "reenvio: %u avisos de descarte, último '%s'", num_descartes, ultimo_descarte);
+    escoar();
+    VERIFICAR(posicao("/casa/sala/luz", "10.00") >= 0, "reenvio: slot 0 não saiu");
+    VERIFICAR(posicao("/casa/quarto1/luz", NULL) < 0, "reenvio: o descartado saiu");
+
+    // Próximo ciclo, valores iguais: o que saiu é suprimido, o descartado sai de novo
+    reiniciar_envios(true);
+    relogio_us += CICLO_US;
+    VERIFICAR(!publicacao_publicar(0, "/casa/sala/luz", "10.00", true), "reenvio: slot 0 não foi suprimido");
+    VERIFICAR(publicacao_publicar(1, "/casa/quarto1/luz", "20.00", true), "reenvio: slot 1 ficou suprimido");
+    escoar();
+    VERIFICAR(num_enviadas == 1 && posicao("/casa/quarto1/luz", "20.00") == 0, "reenvio: %u enviadas no ciclo seguinte",
+              num_enviadas);
+
+    // Tópico que nenhum slot publicou não invalida nada
+    uint slot;
+    VERIFICAR(!publicacao_invalidar("/casa/inexistente", &slot), "reenvio: tópico desconhecido achou o slot %u", slot);
+}
+
+static void bancada(long mensagens)
+{
+    static const char *const topicos[] = {
+        "/casa/sala/luz",     "/casa/sala/estado",     "/casa/sala/janela/pos",     "/casa/sala/luz/estado",
+        "/casa/quarto1/luz",  "/casa/quarto1/estado",  "/casa/quarto1/janela/pos",  "/casa/quarto1/luz/estado",
+        "/casa/cozinha/luz",  "/casa/cozinha/estado",  "/casa/cozinha/janela/pos",  "/casa/cozinha/luz/estado",
+        "/casa/temperatura",  "/casa/horario",         "/led/state",                "/uptime",
+    };
+
+    // Broker em dia: cada mensagem sai direto e a confirmação libera a vez
+    reiniciar_envios(true);
+    double inicio = teste_agora_s();
+    for (long i = 0; i < mensagens; i++)
+    {
+        enfileirar(topicos[i % count_of(topicos)], "12.34", (SaidaPrioridade)(i % SAIDA_NUM_PRIORIDADES));
+        saida_concluida(true);
+    }
+    double ns_direta = (teste_agora_s() - inicio) * 1e9 / mensagens;
+
+    // Broker atrasado: a fila fica cheia e cada mensagem mescla com a que espera
+    reiniciar_envios(false);
+    inicio = teste_agora_s();
+    for (long i = 0; i < mensagens; i++)
+    {
+        enfileirar(topicos[i % count_of(topicos)], "12.34", SAIDA_ESTADO);
+    }
+    double ns_mescla = (teste_agora_s() - inicio) * 1e9 / mensagens;
+    escoar();
+
+    printf("bancada (%ld mensagens, %u tópicos):\n", mensagens, (uint)count_of(topicos));
+    printf("  enviada direto   %6.1f ns/mensagem\n", ns_direta);
+    printf("  mesclada na fila %6.1f ns/mensagem\n", ns_mescla);
+}
+
+int main(int argc, char **argv)
+{
+    long mensagens = MENSAGENS_PADRAO;
+    if (argc == 3 && strcmp(argv[1], "--mensagens") == 0)
+    {
+        mensagens = atol(argv[2]);
+    }
+
+    init_saida(enviar, descartada, NULL);
+    init_publicacao(transporte, NULL, PUBLICACAO_HEARTBEAT_MS);
+    testar_mescla();
+    testar_prioridade();
+    testar_fila_cheia();
+    testar_reenvio();
+    if (mensagens > 0)
+    {
+        bancada(mensagens);
+    }
+    return teste_resultado("saida");
+}
@@ -0,0 +1,224 @@
+// Teste e bancada do blitter do OLED (lib/ssd1306.c).
+//
+//   teste_ssd1306 [--operacoes N] [--repeticoes N]
+//
+// Compara fill, rect (cheio e contorno), hline e vline byte a byte com um
+// caminho de referência que desenha pixel a pixel por ssd1306_pixel(), com
+// coordenadas aleatórias que incluem pontos fora da tela (recorte), nos
+// painéis de 128x64 e 128x32. As janelas sujas também precisam coincidir.
+// Depois mede cada primitiva nos dois caminhos e imprime o ganho.
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "ssd1306.h"
+#include "teste.h"
+
+#define OPERACOES_PADRAO 200000L
+#define REPETICOES_PADRAO 20000L
+
+// ---- Referência pixel a pixel, com o mesmo recorte que o blitter promete ----
+
+static void ref_fill(ssd1306_t *ssd, bool value)
+{
+    for (uint y = 0; y < ssd->height; ++y)
+        for (uint x = 0; x < ssd->width; ++x)
+            ssd1306_pixel(ssd, x, y, value);
+}
+
+static void ref_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill)
+{
+    uint right = left + width - 1, bottom = top + height - 1;
+    for (uint x = left; x < (uint)left + width; ++x)
+        for (uint y = top; y < (uint)top + height; ++y)
+            if (fill || x == left || x == right || y == top || y == bottom)
+                if (x < 256 && y < 256)
+                    ssd1306_pixel(ssd, x, y, value);
+}
+
+static void ref_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value)
+{
+    uint de = x0 < x1 ? x0 : x1, ate = x0 < x1 ? x1 : x0;
+    for (uint x = de; x <= ate; ++x)
+        ssd1306_pixel(ssd, x, y, value);
+}
+
+static void ref_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value)
+{
+    uint de = y0 < y1 ? y0 : y1, ate = y0 < y1 ? y1 : y0;
+    for (uint y = de; y <= ate; ++y)
+        ssd1306_pixel(ssd, x, y, value);
+}
+
+// ---- Comparação ----
+
+static uint32_t semente = 12345;
+
+static uint32_t aleatorio(void)
+{
+    semente ^= semente << 13;
+    semente ^= semente >> 17;
+    semente ^= semente << 5;
+    return semente;
+}
+
+// Coordenada quase sempre dentro da tela, às vezes além da borda ou no fim do uint8_t
+static uint8_t coordenada(uint limite)
+{
+    uint32_t r = aleatorio();
+    switch (r & 7)
+    {
+    case 0:
+        return (uint8_t)(limite - 1 + (r >> 8) % 3); // Na borda ou logo depois
+    case 1:
+        return (uint8_t)(r >> 8);
+    default:
+        return (uint8_t)((r >> 8) % limite);
+    }
+}
+
+static bool iguais(const ssd1306_t *a, const ssd1306_t *b)
+{
+    return memcmp(a->ram_buffer, b->ram_buffer, a->bufsize) == 0 &&
+           memcmp(a->dirty_x0, b->dirty_x0, sizeof(a->dirty_x0)) == 0 &&
+           memcmp(a->dirty_x1, b->dirty_x1, sizeof(a->dirty_x1)) == 0;
+}
+
+static void limpar_sujeira(ssd1306_t *ssd)
+{
+    memset(ssd->dirty_x0, 0xFF, sizeof(ssd->dirty_x0));
+    memset(ssd->dirty_x1, 0x00, sizeof(ssd->dirty_x1));
+}
+
+static void testar_painel(uint8_t altura, long operacoes)
+{
+    static const char *const nomes[] = {"fill", "rect cheio", "rect contorno", "hline", "vline"};
+    ssd1306_t blit, ref;
+    ssd1306_init(&blit, WIDTH, altura, false, 0x3C, NULL);
+    ssd1306_init(&ref, WIDTH, altura, false, 0x3C, NULL);
+    uint falhas[count_of(nomes)] = {0};
+
+    for (long n = 0; n < operacoes; n++)
+    {
+        // Conteúdo aleatório de vez em quando, para o valor desenhado importar
+        if (n % 64 == 0)
+        {
+            for (size_t i = 1; i < blit.bufsize; i++)
+            {
+                blit.ram_buffer[i] = ref.ram_buffer[i] = (uint8_t)aleatorio();
+            }
+        }
+        limpar_sujeira(&blit);
+        limpar_sujeira(&ref);
+
+        uint op = aleatorio() % 32;
+        op = op == 0 ? 0 : 1 + op % 4; // fill é raro: apaga o resto do teste
+        bool valor = aleatorio() & 1;
+        uint8_t a = coordenada(WIDTH), b = coordenada(WIDTH);
+        uint8_t c = coordenada(altura), d = coordenada(altura);
+        switch (op)
+        {
+        case 0:
+            ssd1306_fill(&blit, valor);
+            ref_fill(&ref, valor);
+            break;
+        case 1:
+        case 2:
+            ssd1306_rect(&blit, c, a, b, d, valor, op == 1);
+            ref_rect(&ref, c, a, b, d, valor, op == 1);
+            break;
+        case 3:
+            ssd1306_hline(&blit, a, b, c, valor);
+            ref_hline(&ref, a, b, c, valor);
+            break;
+        default:
+            ssd1306_vline(&blit, a, c, d, valor);
+            ref_vline(&ref, a, c, d, valor);
+            break;
+        }
+        if (!iguais(&blit, &ref))
+        {
+            if (falhas[op]++ == 0)
+            {
+                VERIFICAR(false, "%ux%u: %s(%u, %u, %u, %u, %d) difere da referência", WIDTH, altura, nomes[op], a, b,
+                          c, d, valor);
+            }
+            memcpy(ref.ram_buffer, blit.ram_buffer, blit.bufsize); // Segue comparando as próximas
+        }
+    }
+}
+
+// ---- Bancada ----
+
+static double medir(void (*desenhar)(ssd1306_t *, bool), ssd1306_t *ssd, long repeticoes)
+{
+    double inicio = teste_agora_s();
+    for (long i = 0; i < repeticoes; i++)
+    {
+        desenhar(ssd, i & 1);
+    }
+    return (teste_agora_s() - inicio) * 1e9 / repeticoes;
+}
+
+// Os casos comuns do painel: tela inteira, barra, molduras e linhas de largura total
+static void blit_fill(ssd1306_t *s, bool v) { ssd1306_fill(s, v); }
+static void ref_fill_b(ssd1306_t *s, bool v) { ref_fill(s, v); }
+static void blit_barra(ssd1306_t *s, bool v) { ssd1306_rect(s, 13, 3, 120, 37, v, true); }
+static void ref_barra(ssd1306_t *s, bool v) { ref_rect(s, 13, 3, 120, 37, v, true); }
+static void blit_moldura(ssd1306_t *s, bool v) { ssd1306_rect(s, 0, 0, 128, 64, v, false); }
+static void ref_moldura(ssd1306_t *s, bool v) { ref_rect(s, 0, 0, 128, 64, v, false); }
+static void blit_hline(ssd1306_t *s, bool v) { ssd1306_hline(s, 0, 127, 21, v); }
+static void ref_hline_b(ssd1306_t *s, bool v) { ref_hline(s, 0, 127, 21, v); }
+static void blit_vline(ssd1306_t *s, bool v) { ssd1306_vline(s, 64, 0, 63, v); }
+static void ref_vline_b(ssd1306_t *s, bool v) { ref_vline(s, 64, 0, 63, v); }
+
+static void bancada(long repeticoes)
+{
+    static const struct
+    {
+        const char *nome;
+        void (*blit)(ssd1306_t *, bool);
+        void (*ref)(ssd1306_t *, bool);
+    } casos[] = {
+        {"fill", blit_fill, ref_fill_b},
+        {"rect 120x37 cheio", blit_barra, ref_barra},
+        {"rect 128x64 contorno", blit_moldura, ref_moldura},
+        {"hline 128", blit_hline, ref_hline_b},
+        {"vline 64", blit_vline, ref_vline_b},
+    };
+    ssd1306_t ssd;
+    ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, NULL);
+
+    printf("bancada (%ld repetições, 128x64):\n", repeticoes);
+    printf("  %-22s %10s %10s %8s\n", "", "blitter", "pixel", "ganho");
+    for (uint i = 0; i < count_of(casos); i++)
+    {
+        double ns_blit = medir(casos[i].blit, &ssd, repeticoes);
+        double ns_ref = medir(casos[i].ref, &ssd, repeticoes / 4 + 1);
+        printf("  %-22s %7.1f ns %7.1f ns %7.1fx\n", casos[i].nome, ns_blit, ns_ref, ns_ref / ns_blit);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    long operacoes = OPERACOES_PADRAO, repeticoes = REPETICOES_PADRAO;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        if (strcmp(argv[i], "--operacoes") == 0)
+        {
+            operacoes = atol(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--repeticoes") == 0)
+        {
+            repeticoes = atol(argv[i + 1]);
+        }
+    }
+
+    testar_painel(64, operacoes);
+    testar_painel(32, operacoes);
+    if (repeticoes > 0)
+    {
+        bancada(repeticoes);
+    }
+    return teste_resultado("ssd1306");
+}
@@ -0,0 +1,72 @@
+#include "planta.h"
+#include <math.h>
+
+// Gerador pseudoaleatório próprio, para cenários reproduzíveis em qualquer libc
+static float aleatorio(Planta *p)
+{
+    p->semente = p->semente * 1664525u + 1013904223u;
+    return (float)(p->semente >> 8) / (float)(1u << 24);
+}
+
+// Aproximação de uma normal com média 0 e desvio 1 (soma de 4 uniformes)
+static float gaussiano(Planta *p)
+{
+    float s = aleatorio(p) + aleatorio(p) + aleatorio(p) + aleatorio(p);
+    return (s - 2.0f) * 1.7320508f;
+}
+
+static float luz_do_dia(const Planta *p)
+{
+    double h = fmod(p->t_s / 3600.0, 24.0);
+    if (h <= p->dia.nascer_h || h >= p->dia.por_h)
+    {
+        return 0.0f;
+    }
+    float s = (float)sin(M_PI * (h - p->dia.nascer_h) / (p->dia.por_h - p->dia.nascer_h));
+    return p->dia.pico * s * (1.0f - p->nuvem);
+}
+
+void planta_init(Planta *p, const PlantaDia *dia, const PlantaComodo *comodo, double inicio_h, uint32_t semente)
+{
+    p->dia = *dia;
+    p->comodo = *comodo;
+    p->t_s = inicio_h * 3600.0;
+    p->semente = semente;
+    p->nuvem = dia->nuvens * 0.5f;
+    p->janela = 0;
+    p->lampada_ligada = false;
+    p->luz_ldr = planta_luz_real(p);
+}
+
+float planta_luz_real(const Planta *p)
+{
+    float abertura = p->janela / 10000.0f;
+    float luz = p->comodo.fundo + p->comodo.externa * luz_do_dia(p) * powf(abertura, p->comodo.gama);
+    if (p->lampada_ligada)
+    {
+        luz += p->comodo.lampada;
+    }
+    return luz > 100.0f ? 100.0f : luz;
+}
+
+void planta_avancar(Planta *p, double dt_s)
+{
+    p->t_s += dt_s;
+    if (p->dia.nuvens > 0.0f)
+    {
+        // Ornstein-Uhlenbeck em torno de nuvens/2, com desvio de nuvens/3, limitado a [0, nuvens]
+        float media = p->dia.nuvens * 0.5f;
+        float sigma = (p->dia.nuvens / 3.0f) / sqrtf(p->dia.nuvens_tau_s * 0.5f);
+        p->nuvem += (media - p->nuvem) * (float)(dt_s / p->dia.nuvens_tau_s) + sigma * sqrtf((float)dt_s) * gaussiano(p);
+        p->nuvem = p->nuvem < 0.0f ? 0.0f : (p->nuvem > p->dia.nuvens ? p->dia.nuvens : p->nuvem);
+    }
+    float k = (float)(dt_s / p->comodo.ldr_tau_s);
+    p->luz_ldr += (planta_luz_real(p) - p->luz_ldr) * (k > 1.0f ? 1.0f : k);
+}
+
+uint16_t planta_ler_ldr(Planta *p)
+{
+    float luz = p->luz_ldr + p->comodo.ruido * gaussiano(p);
+    luz = luz < 0.0f ? 0.0f : (luz > 100.0f ? 100.0f : luz);
+    return (uint16_t)lroundf(luz * 100.0f);
+}
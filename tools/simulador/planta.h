@@ -0,0 +1,46 @@
+#ifndef PLANTA_H
+#define PLANTA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// Luz do dia vista de fora da janela
+typedef struct
+{
+    const char *nome;
+    float nascer_h, por_h; // Nascer e pôr do sol (hora do dia)
+    float pico;            // Fração da luz externa máxima ao meio-dia (0-1)
+    float nuvens;          // Quanto as nuvens podem tapar (0 = céu limpo, 1 = tudo)
+    float nuvens_tau_s;    // Rapidez com que as nuvens mudam
+} PlantaDia;
+
+// Cômodo: janela, lâmpada e o LDR
+typedef struct
+{
+    const char *nome;
+    float externa;     // Luz no LDR com a janela toda aberta e sol pleno (%)
+    float gama;        // Transmitância da janela = abertura^gama
+    float fundo;       // Luz com a janela fechada e a lâmpada apagada (%)
+    float lampada;     // Contribuição da lâmpada (%)
+    float ldr_tau_s;   // Constante de tempo do LDR com a cadeia de filtros
+    float ruido;       // Desvio padrão do ruído da leitura (%)
+} PlantaComodo;
+
+typedef struct
+{
+    PlantaDia dia;
+    PlantaComodo comodo;
+    double t_s;        // Segundos desde a meia-noite
+    float nuvem;       // Fração tapada agora (0-1)
+    float luz_ldr;     // Luz "vista" pelo LDR, já com o atraso e sem ruído (%)
+    uint16_t janela;   // Abertura atual, em centésimos
+    bool lampada_ligada;
+    uint32_t semente;
+} Planta;
+
+void planta_init(Planta *p, const PlantaDia *dia, const PlantaComodo *comodo, double inicio_h, uint32_t semente);
+void planta_avancar(Planta *p, double dt_s);
+float planta_luz_real(const Planta *p);   // Luz no cômodo agora, sem atraso (%)
+uint16_t planta_ler_ldr(Planta *p);       // Leitura com ruído, em centésimos (0-10000)
+
+#endif
@@ -0,0 +1,433 @@
+// Simulador da automação de iluminação no host.
+//
+// Roda o controlador de verdade (controle.c) e a camada de publicação
+// (publicacao.c) contra um modelo do cômodo (planta.c), com o mesmo ciclo de
+// 2 s do firmware. read_ldr/set_janela/set_luz são substituídos pela planta.
+//
+//   simulador [opções]          traço CSV de um cenário, um ciclo por linha
+//   simulador --bench [opções]  tabela de métricas para a matriz de cenários
+//
+// Opções: --controle pid|passos, --dia N, --comodo N, --horas H, --ganhos "kp=0.1 ki=0.1"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "comodo.h"
+#include "controle.h"
+#include "formato.h"
+#include "planta.h"
+#include "publicacao.h"
+
+#define CICLO_MS 2000          // TEMP_WORKER_TIME_S do firmware
+#define PASSO_PLANTA_MS 100    // Resolução da simulação da planta
+#define TROCA_ALVO_MIN 45      // Intervalo entre mudanças de alvo
+#define INICIO_H 5.0           // Começa antes do nascer do sol, com a lâmpada em jogo
+#define HORAS_PADRAO 14.0
+#define TOLERANCIA 2.0f        // Faixa de acomodação (%), a mesma do controlador
+#define CONFIRMACAO_S 4.0      // Tempo na faixa para contar como acomodado
+
+static const uint16_t alvos[] = {COMODO_PORCENTO(65), COMODO_PORCENTO(40), COMODO_PORCENTO(80), COMODO_PORCENTO(55)};
+
+static const PlantaDia dias[] = {
+    {"ensolarado", 6.0f, 18.0f, 1.0f, 0.0f, 60.0f},
+    {"nublado", 6.0f, 18.0f, 0.9f, 0.7f, 90.0f},
+    {"inverno", 7.0f, 17.0f, 0.5f, 0.3f, 300.0f},
+};
+
+static const PlantaComodo comodos_planta[] = {
+    {"janela_grande", 90.0f, 1.0f, 3.0f, 35.0f, 0.5f, 0.5f},
+    {"janela_pequena", 55.0f, 1.6f, 5.0f, 30.0f, 0.5f, 0.8f},
+};
+
+typedef enum
+{
+    CONTROLE_PID,    // controle.c
+    CONTROLE_PASSOS, // Degraus de 5/2/1% da versão anterior (cópia à mão)
+} TipoControle;
+
+static const char *const nomes_controle[] = {"pid", "passos"};
+
+typedef struct
+{
+    uint32_t degraus;
+    uint32_t acomodados;
+    double soma_acomodacao_s;
+    float sobressinal_max;
+    uint32_t trocas_luz;
+    uint32_t movimentos;
+    uint32_t publicacoes;
+    double soma_erro;     // Integral de |luz - alvo| (% x s)
+    double tempo_s;
+} Metricas;
+
+// Estado de uma simulação; as funções de "hardware" abaixo agem sobre ela
+typedef struct
+{
+    Planta planta;
+    Comodo comodo;
+    TipoControle tipo;
+    bool flag;            // Trava da lâmpada da versão anterior
+    int32_t luz_publicada;
+    Metricas m;
+
+    // Medição da resposta ao degrau em curso (sobre a luz real, sem ruído)
+    double degrau_s;
+    double dentro_s;      // < 0: fora da faixa
+    bool acomodado;
+    int sentido;
+    float sobressinal;
+} Simulacao;
+
+static Simulacao *sim;
+static const ComodoTopicos topicos = {
+    .estado = "/casa/sim/estado",
+    .luz = "/casa/sim/luz",
+    .luz_estado = "/casa/sim/luz/estado",
+    .janela_pos = "/casa/sim/janela/pos",
+    .janela_estado = "/casa/sim/janela/estado",
+};
+
+uint64_t time_us_64(void)
+{
+    return (uint64_t)(sim->planta.t_s * 1e6);
+}
+
+static uint32_t agora_ms(void)
+{
+    return (uint32_t)(sim->planta.t_s * 1000.0);
+}
+
+static bool transporte_contador(void *ctx, uint slot, const char *topico, const void *payload, uint16_t len, bool retain)
+{
+    sim->m.publicacoes++;
+    return true;
+}
+
+// ---- Substitutos do hardware ----
+
+static uint16_t read_ldr(void)
+{
+    return planta_ler_ldr(&sim->planta);
+}
+
+static void set_janela(uint16_t pos)
+{
+    if (pos != sim->planta.janela)
+    {
+        sim->m.movimentos++;
+    }
+    sim->planta.janela = pos;
+    sim->comodo.janela_pos = pos;
+}
+
+static void set_luz(bool on)
+{
+    if (on != sim->planta.lampada_ligada)
+    {
+        sim->m.trocas_luz++;
+    }
+    sim->planta.lampada_ligada = on;
+    sim->comodo.luz_ligada = on;
+}
+
+static void avancar(double dt_s)
+{
+    for (double t = 0; t < dt_s - 1e-9; t += PASSO_PLANTA_MS / 1000.0)
+    {
+        planta_avancar(&sim->planta, PASSO_PLANTA_MS / 1000.0);
+
+        // Métricas sobre a luz real a cada passo da planta
+        float alvo = sim->comodo.iluminacao_alvo / 100.0f;
+        float erro = planta_luz_real(&sim->planta) - alvo;
+        sim->m.soma_erro += fabsf(erro) * (PASSO_PLANTA_MS / 1000.0);
+        sim->m.tempo_s += PASSO_PLANTA_MS / 1000.0;
+        if (sim->acomodado)
+        {
+            continue;
+        }
+        if (erro * sim->sentido > sim->sobressinal)
+        {
+            sim->sobressinal = erro * sim->sentido;
+        }
+        if (fabsf(erro) > TOLERANCIA)
+        {
+            sim->dentro_s = -1;
+        }
+        else if (sim->dentro_s < 0)
+        {
+            sim->dentro_s = sim->planta.t_s;
+        }
+        else if (sim->planta.t_s - sim->dentro_s >= CONFIRMACAO_S)
+        {
+            sim->acomodado = true;
+            sim->m.acomodados++;
+            sim->m.soma_acomodacao_s += sim->dentro_s - sim->degrau_s;
+            if (sim->sobressinal > sim->m.sobressinal_max)
+            {
+                sim->m.sobressinal_max = sim->sobressinal;
+            }
+        }
+    }
+}
+
+static void mudar_alvo(uint16_t alvo)
+{
+    sim->comodo.iluminacao_alvo = alvo;
+    sim->m.degraus++;
+    sim->degrau_s = sim->planta.t_s;
+    sim->dentro_s = -1;
+    sim->acomodado = false;
+    sim->sobressinal = 0;
+    sim->sentido = planta_luz_real(&sim->planta) < alvo / 100.0f ? 1 : -1;
+}
+
+// ---- Controladores, espelhando automacao_iluminacao() do firmware ----
+
+static void automacao_pid(void)
+{
+    uint16_t luz_atual = read_ldr();
+    sim->comodo.luz = luz_atual;
+    ControleAcao acao = controle_passo(&sim->comodo.controle, luz_atual, sim->comodo.iluminacao_alvo,
+                                       sim->comodo.janela_pos, sim->comodo.luz_ligada, agora_ms());
+    if (acao.janela_pos != sim->comodo.janela_pos)
+    {
+        set_janela(acao.janela_pos);
+    }
+    if (acao.luz_ligada != sim->comodo.luz_ligada)
+    {
+        set_luz(acao.luz_ligada);
+    }
+}
+
+// Algoritmo anterior ao controle.c, mantido aqui como referência de comparação.
+// É uma cópia à mão do antigo automacao_iluminacao() de aplicacao.c, não o
+// código do firmware: mudanças em aplicacao.c não aparecem aqui
+static void automacao_passos(void)
+{
+    Comodo *c = &sim->comodo;
+    int32_t luz_atual = read_ldr();
+    int32_t alvo = c->iluminacao_alvo;
+    int32_t tolerancia = COMODO_PORCENTO(2);
+    int32_t diferenca = abs(luz_atual - alvo);
+    int32_t incremento = diferenca > COMODO_PORCENTO(20)   ? COMODO_PORCENTO(5)
+                         : diferenca > COMODO_PORCENTO(10) ? COMODO_PORCENTO(2)
+                                                           : COMODO_PORCENTO(1);
+
+    if (diferenca > tolerancia)
+    {
+        if (luz_atual < alvo - tolerancia && c->janela_pos < COMODO_100_PORCENTO)
+        {
+            int32_t pos = c->janela_pos + incremento;
+            set_janela(pos > COMODO_100_PORCENTO ? COMODO_100_PORCENTO : pos);
+            avancar(0.1);
+            luz_atual = read_ldr();
+            diferenca = abs(luz_atual - alvo);
+        }
+        else if (luz_atual > alvo + tolerancia && c->janela_pos > 0)
+        {
+            int32_t pos = c->janela_pos - incremento;
+            set_janela(pos < 0 ? 0 : pos);
+            avancar(0.1);
+            luz_atual = read_ldr();
+            diferenca = abs(luz_atual - alvo);
+        }
+        if (c->luz_ligada && luz_atual >= alvo - tolerancia)
+        {
+            set_luz(false);
+            avancar(0.1);
+            luz_atual = read_ldr();
+            diferenca = abs(luz_atual - alvo);
+        }
+    }
+    if (diferenca > tolerancia && c->janela_pos >= COMODO_100_PORCENTO && !c->luz_ligada && sim->flag)
+    {
+        set_luz(true);
+        sim->flag = false;
+    }
+    if (sim->flag)
+    {
+        set_luz(false);
+    }
+}
+
+// Mesmos tópicos e formatos que o worker do firmware publica por ciclo
+static void publicar(void)
+{
+    Comodo *c = &sim->comodo;
+    char texto[128];
+
+    int32_t luz = read_ldr();
+    if (abs(luz - sim->luz_publicada) > 50)
+    {
+        sim->luz_publicada = luz;
+    }
+    formato_centesimos(texto, sizeof(texto), sim->luz_publicada);
+    publicacao_publicar(0, c->topicos->luz, texto, true);
+
+    Json json;
+    json_abrir(&json, texto, sizeof(texto));
+    json_centesimos(&json, "luz", sim->luz_publicada); // Mesma zona morta do tópico de luz
+    json_centesimos(&json, "janela", c->janela_pos);
+    json_inteiro(&json, "luz_ligada", c->luz_ligada);
+    json_texto(&json, "modo", "auto");
+    json_inteiro(&json, "modo_dormir", 0);
+    json_centesimos(&json, "iluminacao_alvo", c->iluminacao_alvo);
+    json_fechar(&json);
+    publicacao_publicar(1, c->topicos->estado, texto, true);
+    publicacao_publicar(2, c->topicos->janela_estado, c->janela_pos > 0 ? "on" : "off", true);
+    formato_centesimos(texto, sizeof(texto), c->janela_pos);
+    publicacao_publicar(3, c->topicos->janela_pos, texto, true);
+    publicacao_publicar(4, c->topicos->luz_estado, c->luz_ligada ? "on" : "off", true);
+}
+
+static void simular(Simulacao *s, TipoControle tipo, const PlantaDia *dia, const PlantaComodo *comodo, double horas,
+                    const char *ganhos, bool traco)
+{
+    memset(s, 0, sizeof(*s));
+    sim = s;
+    s->tipo = tipo;
+    s->flag = true;
+    s->luz_publicada = -1000;
+    s->comodo = (Comodo){.nome = "sim", .topicos = &topicos, .modo_auto = true, .controle = CONTROLE_PADRAO};
+    planta_init(&s->planta, dia, comodo, INICIO_H, 12345u);
+    if (ganhos)
+    {
+        controle_ler_ganhos(&s->comodo.controle, ganhos);
+    }
+    controle_reiniciar(&s->comodo.controle, agora_ms());
+    init_publicacao(transporte_contador, NULL, PUBLICACAO_HEARTBEAT_MS);
+
+    uint32_t ciclos = (uint32_t)(horas * 3600.0 * 1000.0 / CICLO_MS);
+    uint32_t ciclos_por_alvo = TROCA_ALVO_MIN * 60u * 1000u / CICLO_MS;
+    if (traco)
+    {
+        printf("hora,alvo,luz_real,luz_ldr,janela,lampada,ganho_planta\n");
+    }
+    for (uint32_t i = 0; i < ciclos; i++)
+    {
+        if (i % ciclos_por_alvo == 0)
+        {
+            mudar_alvo(alvos[(i / ciclos_por_alvo) % count_of(alvos)]);
+        }
+        double inicio_s = s->planta.t_s;
+        if (tipo == CONTROLE_PID)
+        {
+            automacao_pid();
+        }
+        else
+        {
+            automacao_passos();
+        }
+        publicar();
+        if (traco)
+        {
+            printf("%.4f,%.2f,%.2f,%.2f,%.2f,%d,%.3f\n", s->planta.t_s / 3600.0, s->comodo.iluminacao_alvo / 100.0,
+                   planta_luz_real(&s->planta), s->planta.luz_ldr, s->comodo.janela_pos / 100.0, s->comodo.luz_ligada,
+                   s->comodo.controle.ganho_planta / 65536.0);
+        }
+        avancar(CICLO_MS / 1000.0 - (s->planta.t_s - inicio_s));
+    }
+}
+
+static void imprimir_metricas(const char *cenario, TipoControle tipo, const Metricas *m)
+{
+    double horas = m->tempo_s / 3600.0;
+    char acomodacao[16] = "-"; // Nenhuma mudança de alvo acomodou: não há média
+    if (m->acomodados)
+    {
+        snprintf(acomodacao, sizeof(acomodacao), "%.1f", m->soma_acomodacao_s / m->acomodados);
+    }
+    printf("%-26s %-7s %9s %10.2f %5u/%-3u %8.1f %8.1f %8.1f %8.2f\n", cenario, nomes_controle[tipo], acomodacao,
+           m->sobressinal_max, m->acomodados, m->degraus, m->trocas_luz / horas, m->movimentos / horas,
+           m->publicacoes / horas, m->soma_erro / m->tempo_s);
+}
+
+static void uso(const char *programa)
+{
+    fprintf(stderr, "uso: %s [--bench] [--controle pid|passos] [--dia N] [--comodo N] [--horas H] [--ganhos \"kp=.. ki=..\"]\n",
+            programa);
+    exit(2);
+}
+
+int main(int argc, char **argv)
+{
+    bool bench = false;
+    int controle = -1, dia = -1, comodo = -1;
+    double horas = HORAS_PADRAO;
+    const char *ganhos = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--bench") == 0)
+        {
+            bench = true;
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--controle") == 0)
+        {
+            controle = strcmp(argv[++i], "passos") == 0 ? CONTROLE_PASSOS : CONTROLE_PID;
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--dia") == 0)
+        {
+            dia = atoi(argv[++i]) % (int)count_of(dias);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--comodo") == 0)
+        {
+            comodo = atoi(argv[++i]) % (int)count_of(comodos_planta);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--horas") == 0)
+        {
+            horas = atof(argv[++i]);
+        }
+        else if (i + 1 < argc && strcmp(argv[i], "--ganhos") == 0)
+        {
+            ganhos = argv[++i];
+        }
+        else
+        {
+            uso(argv[0]);
+        }
+    }
+
+    static Simulacao s;
+    if (!bench)
+    {
+        simular(&s, controle < 0 ? CONTROLE_PID : controle, &dias[dia < 0 ? 0 : dia],
+                &comodos_planta[comodo < 0 ? 0 : comodo], horas, ganhos, true);
+        return 0;
+    }
+
+    printf("%-26s %-7s %9s %10s %9s %8s %8s %8s %8s\n", "cenario", "controle", "acomod_s", "sobressin%", "acomod",
+           "trocas/h", "movim/h", "publ/h", "erro%");
+    for (uint d = 0; d < count_of(dias); d++)
+    {
+        if (dia >= 0 && (int)d != dia)
+        {
+            continue;
+        }
+        for (uint c = 0; c < count_of(comodos_planta); c++)
+        {
+            if (comodo >= 0 && (int)c != comodo)
+            {
+                continue;
+            }
+            char cenario[64];
+            snprintf(cenario, sizeof(cenario), "%s/%s", dias[d].nome, comodos_planta[c].nome);
+            for (int t = CONTROLE_PID; t <= CONTROLE_PASSOS; t++)
+            {
+                if (controle >= 0 && t != controle)
+                {
+                    continue;
+                }
+                simular(&s, t, &dias[d], &comodos_planta[c], horas, ganhos, false);
+                imprimir_metricas(cenario, t, &s.m);
+            }
+        }
+    }
+    if (controle != CONTROLE_PID)
+    {
+        printf("\npassos: copia a mao do antigo automacao_iluminacao() de aplicacao.c, nao o firmware\n");
+    }
+    return 0;
+}